@@ -0,0 +1,59 @@
+#pragma once
+
+#include <Ogre.h>
+#include "PathFollow2.h"
+#include "util/CellPath.h"
+#include "util/CellUtil.h"
+
+using namespace Ogre;
+
+// PathFollow2 over a CellPath: waypoints are cell centres, decoded one at a time.
+class CellPathFollow : public PathFollow2
+{
+    using Centers = CellPath::MappedRange<CellUtil::CellCenter>;
+
+    CellPath cells;
+    Centers::MappedIterator next;
+    Centers::MappedIterator end;
+
+public:
+    CellPathFollow(Vector2 position, const CellPath &cells)
+        : PathFollow2(position, {}), cells(cells),
+          next(CellUtil::cellCenters(this->cells).begin()), end(CellUtil::cellCenters(this->cells).end())
+    {
+        // like PathFollow2, the start cell itself is not a waypoint
+        if (next != end)
+        {
+            ++next;
+        }
+    }
+
+    CellPathFollow(const CellPathFollow &) = delete;
+    CellPathFollow &operator=(const CellPathFollow &) = delete;
+
+    bool move(float timeEscape, Vector2 &currentPos, Vector2 &direction) override
+    {
+        for (; next != end; ++next)
+        {
+            Vector2 nextPos = *next;
+            direction = nextPos - position;
+
+            float distance = direction.length();
+            if (distance < 0.01f)
+            {
+                continue;
+            }
+            direction.normalise();
+            float move = speed * timeEscape;
+            if (move > distance)
+            {
+                move = distance;
+            }
+
+            position += direction * move;
+            currentPos = this->position;
+            return true;
+        }
+        return false;
+    }
+};
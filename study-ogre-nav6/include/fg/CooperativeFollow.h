@@ -0,0 +1,50 @@
+#pragma once
+
+#include <Ogre.h>
+#include "PathFollow2.h"
+#include "Ground.h"
+#include "util/CooperativePathfinder.h"
+
+using namespace Ogre;
+
+// PathFollow2 that walks towards the cell a CooperativePathfinder agent holds
+// in the current tick; the planner decides when, and whether, to move on.
+class CooperativeFollow : public PathFollow2
+{
+    CooperativePathfinder *planner;
+    int agent;
+    Vector2 heading = Vector2::UNIT_X; // kept while waiting
+
+public:
+    CooperativeFollow(Vector2 position, CooperativePathfinder *planner, int agent)
+        : PathFollow2(position, {}), planner(planner), agent(agent)
+    {
+    }
+
+    bool move(float timeEscape, Vector2 &currentPos, Vector2 &direction) override
+    {
+        CellKey cell = planner->getCell(agent);
+        Vector2 nextPos = Ground::calculateCenter(cell.first, cell.second);
+        direction = nextPos - position;
+
+        float distance = direction.length();
+        if (distance < 0.01f)
+        {
+            // waiting for the next tick, or done once parked on the goal
+            direction = heading;
+            currentPos = this->position;
+            return !planner->isAtGoal(agent);
+        }
+        direction.normalise();
+        heading = direction;
+        float move = speed * timeEscape;
+        if (move > distance)
+        {
+            move = distance;
+        }
+
+        position += direction * move;
+        currentPos = this->position;
+        return true;
+    }
+};
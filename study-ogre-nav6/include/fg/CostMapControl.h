@@ -6,6 +6,7 @@
 #include <OgreColourValue.h>
 #include "fg/defines.h"
 #include "fg/util/CostMap.h"
+#include "fg/util/CostMapFile.h"
 #include "fg/util/Component.h"
 #include "fg/State.h"
 #include "fg/MaterialNames.h"
@@ -39,4 +40,19 @@ public:
         this->setCost(4, 3, CostMap::OBSTACLE);
         this->setCost(7, 5, CostMap::OBSTACLE);
     }
+
+    CostMapControl(const MappedCostLayer &layer) : CostMap(layer)
+    {
+    }
+
+    // The map in file if it can be opened, else the built-in one.
+    static CostMapControl *load(const std::string &file)
+    {
+        MappedCostLayer layer;
+        if (CostMapFile::open(file, layer))
+        {
+            return new CostMapControl(layer);
+        }
+        return new CostMapControl(12, 10);
+    }
 };
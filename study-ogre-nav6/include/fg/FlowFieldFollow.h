@@ -0,0 +1,54 @@
+#pragma once
+
+#include <memory>
+#include <Ogre.h>
+#include "PathFollow2.h"
+#include "Ground.h"
+#include "util/FlowField.h"
+
+using namespace Ogre;
+
+// PathFollow2 that reads its next cell from a shared FlowField instead of a stored path.
+class FlowFieldFollow : public PathFollow2
+{
+    std::shared_ptr<const FlowField> field;
+    const CostMap *costMap;
+    CellKey cell; // cell whose centre is the current waypoint
+
+public:
+    FlowFieldFollow(Vector2 position, std::shared_ptr<const FlowField> field, const CostMap *costMap, CellKey start)
+        : PathFollow2(position, {}), field(field), costMap(costMap), cell(start)
+    {
+        // like PathFollow2, the start cell itself is not a waypoint
+        field->nextCell(*costMap, start.first, start.second, cell.first, cell.second);
+    }
+
+    bool move(float timeEscape, Vector2 &currentPos, Vector2 &direction) override
+    {
+        for (;;)
+        {
+            Vector2 nextPos = Ground::calculateCenter(cell.first, cell.second);
+            direction = nextPos - position;
+
+            float distance = direction.length();
+            if (distance < 0.01f)
+            {
+                if (!field->nextCell(*costMap, cell.first, cell.second, cell.first, cell.second))
+                {
+                    return false;
+                }
+                continue;
+            }
+            direction.normalise();
+            float move = speed * timeEscape;
+            if (move > distance)
+            {
+                move = distance;
+            }
+
+            position += direction * move;
+            currentPos = this->position;
+            return true;
+        }
+    }
+};
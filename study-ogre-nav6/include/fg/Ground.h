@@ -1,6 +1,7 @@
 #pragma once
 #include "State.h"
 #include "util/Polygon2.h"
+#include "util/HexCoord.h"
 #include <Ogre.h>
 #include <OgreVector2.h>
 #include <OgreVector3.h>
@@ -107,8 +108,7 @@ public:
 
     static Ogre::Vector2 calculateCenter(int x, int y, float rad = CostMap::hexSize)
     {
-        float centerX = x * 2 * rad + (y % 2 == 0 ? 0 : rad);
-        float centerY = y * rad * std::sqrt(3.0f);
+        auto [centerX, centerY] = Hex::center(x, y, rad);
         return Ogre::Vector2(centerX, centerY);
     }
 
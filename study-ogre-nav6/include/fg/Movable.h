@@ -4,4 +4,6 @@ class Movable
 {
 public:
     virtual bool setTargetCell(CellKey &cKey2) = 0;
+    // Whether setTargetCell() would take an order now.
+    virtual bool isActive() = 0;
 };
\ No newline at end of file
@@ -8,6 +8,7 @@ using namespace Ogre;
 
 class PathFollow2
 {
+protected:
     std::vector<Ogre::Vector2> path;
     float speed = 30.0f;
     int next = 1;//ignore the first one.
@@ -20,7 +21,11 @@ public:
         this->path = path;
     }
 
-    bool move(float timeEscape, Vector2 &currentPos, Vector2 &direction)
+    virtual ~PathFollow2()
+    {
+    }
+
+    virtual bool move(float timeEscape, Vector2 &currentPos, Vector2 &direction)
     {
         bool rt = false;
         while (next < path.size())
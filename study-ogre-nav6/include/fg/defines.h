@@ -5,7 +5,16 @@
 
 #define ACTOR_SCALE 5.0f
 #define ACTOR_HEIGHT (5 * ACTOR_SCALE)
-
+// movers ordered to one cell at once before they share a flow field
+#define FLOW_FIELD_MIN_MOVABLES 16
+// map loaded at startup if present (see CostMapFile), else the built-in demo map
+#define COST_MAP_FILE "costmap.hxcm"
+// 1: actors plan around each other (CooperativePathfinder) instead of taking independent paths
+#define COOPERATIVE_PATHS 0
+// 1: path searches route around cells where other actors stand (OccupancyLayer)
+#define AVOID_ACTORS 1
+// 1: actors walk straight between turning cells (PathSmoother) instead of centre to centre
+#define SMOOTH_PATHS 0
 
 
 
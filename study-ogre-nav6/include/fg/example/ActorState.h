@@ -2,14 +2,20 @@
 
 #include <Ogre.h>
 #include "fg/PathFollow2.h"
+#include "fg/FlowFieldFollow.h"
+#include "fg/CellPathFollow.h"
+#include "fg/CooperativeFollow.h"
 #include "fg/util/CellUtil.h"
 #include "fg/util/CostMap.h"
+#include "fg/util/PathRequestQueue.h"
+#include "fg/util/PathSmoother.h"
 #include "fg/State.h"
 #include "PathState.h"
 #include "fg/Pickable.h"
 #include "fg/core/PathFollow2MissionState.h"
 #include "fg/util/CollectionUtil.h"
 #include "fg/Movable.h"
+#include "fg/defines.h"
 using namespace Ogre;
 class ActorState : public State, public Pickable, public Ogre::FrameListener, public Movable
 {
@@ -25,17 +31,44 @@ protected:
     PathFollow2MissionState *mission = nullptr;
     std::vector<std::string> aniNames = {"RunBase", "RunTop"};
 
+    PathRequestQueue *pathRequests; // null: search synchronously
+    PathRequestHandle pathRequest;  // order still waiting for its path
+    FlowFieldCache *flowFields;     // null: no flow-field mode
+    bool smoothPaths = SMOOTH_PATHS; // walk straight between turning cells, not centre to centre
+    CooperativePathfinder *cooperative; // null: independent paths
+    int cooperativeAgent = -1;
+    OccupancyLayer *occupancy;          // null: actors do not block cells
+    CellKey occupiedCell;
+    bool occupying = false;
+
 public:
     ActorState(CostMap *costMap, Core *core) : State()
     {
         this->costMap = costMap;
         pathState = new PathState(costMap, core);
+        pathRequests = core->getUserObject<PathRequestQueue>("pathRequests");
+        flowFields = core->getUserObject<FlowFieldCache>("flowFields");
+        cooperative = core->getUserObject<CooperativePathfinder>("cooperativePaths");
+        occupancy = core->getUserObject<OccupancyLayer>("occupancy");
 
         this->setPickable(this);
         this->setFrameListener(this);
         this->setMovable(this);
     }
 
+    ~ActorState()
+    {
+        cancelPathRequest();
+        if (cooperative && cooperativeAgent >= 0)
+        {
+            cooperative->removeAgent(cooperativeAgent);
+        }
+        if (occupancy && occupying)
+        {
+            occupancy->remove(occupiedCell.first, occupiedCell.second);
+        }
+    }
+
     void setEntity(Ogre::Entity *entity)
     {
         this->entity = entity;
@@ -49,7 +82,7 @@ public:
         this->active = active;
     }
 
-    bool isActive()
+    bool isActive() override
     {
         return this->active;
     }
@@ -61,6 +94,11 @@ public:
     {
         this->pathFolow = path;
     }
+
+    void setSmoothPaths(bool smooth)
+    {
+        this->smoothPaths = smooth;
+    }
     bool afterPick(MovableObject *actorMo) override
     {
         // cout << "ActorState::afterPick" << endl;
@@ -82,6 +120,7 @@ public:
             else
             {
                 actor->setActive(false);
+                actor->cancelPathRequest();
                 actor->setPath(nullptr);
                 CellKey start;
                 if (this->pathState->getStart(start))
@@ -108,31 +147,118 @@ public:
         bool hitCell = CellUtil::findCellByPoint(costMap, aPos2, aCellKey);
         if (hitCell)
         {
-            std::vector<Vector2> pathByKey = costMap->findPath(aCellKey, cKey2);
-            std::vector<Vector2> pathByPosition(pathByKey.size());
-            CellUtil::translatePathToCellCenter(pathByKey, pathByPosition);
-            PathFollow2 *path = new PathFollow2(aPos2, pathByPosition);
-            this->setPath(path);
-            pathState->setPath(pathByKey, aCellKey, cKey2);
-            AnimationStateSet *anisSet = entity->getAllAnimationStates();
+            // a newer order supersedes the one still in flight
+            cancelPathRequest();
+            if (cooperative)
+            {
+                startCooperative(aCellKey, cKey2);
+            }
+            else if (flowFields && flowFields->contains(cKey2))
+            {
+                // a field for this goal was built for a group order, follow it instead of searching
+                startFlowField(flowFields->get(cKey2), aCellKey, cKey2);
+            }
+            else if (pathRequests)
+            {
+                pathRequest = pathRequests->submit(aCellKey, cKey2, [this](PathRequest *req)
+                                                   {
+                    this->pathRequest = nullptr;
+                    this->startPath(req->path, req->start, req->end); });
+            }
+            else
+            {
+                CellPath cells;
+                costMap->findPath(aCellKey.first, aCellKey.second, cKey2.first, cKey2.second, PathSearchContext::local(), cells);
+                startPath(cells, aCellKey, cKey2);
+            }
+        }
 
-            // new child state.
-            PathFollow2MissionState *missionState = new PathFollow2MissionState(path, anisSet, aniNames, height);
-            // delete missionState;
+        return true;
+    }
+
+    void cancelPathRequest()
+    {
+        if (pathRequest)
+        {
+            pathRequest->cancel();
+            pathRequest = nullptr;
+        }
+    }
 
-            if (this->mission)
+    // Start moving along a found path; the animation only begins here.
+    void startPath(const CellPath &cells, CellKey aCellKey, CellKey cKey2)
+    {
+        Vector3 aPos3 = this->sceNode->getPosition();
+        float height = 0.0f;
+        Vector2 aPos2 = Ground::Transfer::to2D(aPos3, height);
+        PathFollow2 *path;
+        if (smoothPaths)
+        {
+            std::vector<Vector2> waypoints;
+            for (CellKey cell : PathSmoother(*costMap).smooth(cells))
             {
-                //int size = this->children->size();
-                this->removeChild(this->mission);
-                // std::cout << "children:size" << size << ",after remove child size:" << this->children->size() << std::endl;
+                waypoints.push_back(CellUtil::CellCenter()(cell));
+            }
+            path = new PathFollow2(aPos2, waypoints);
+        }
+        else
+        {
+            path = new CellPathFollow(aPos2, cells);
+        }
+        pathState->setPath(cells, aCellKey, cKey2);
+        startMission(path, height);
+    }
 
-                delete this->mission;
+    void startFlowField(std::shared_ptr<const FlowField> field, CellKey aCellKey, CellKey cKey2)
+    {
+        Vector3 aPos3 = this->sceNode->getPosition();
+        float height = 0.0f;
+        Vector2 aPos2 = Ground::Transfer::to2D(aPos3, height);
+        PathFollow2 *path = new FlowFieldFollow(aPos2, field, costMap, aCellKey);
+        pathState->setPath(field->extractPath(aCellKey.first, aCellKey.second), aCellKey, cKey2);
+        startMission(path, height);
+    }
+
+    // Hand the move to the cooperative planner; the actor keeps its agent between orders.
+    void startCooperative(CellKey aCellKey, CellKey cKey2)
+    {
+        if (cooperativeAgent < 0)
+        {
+            cooperativeAgent = cooperative->addAgent(aCellKey, cKey2);
+            if (cooperativeAgent < 0)
+            {
+                return;
             }
-            this->addChild(missionState);
-            this->mission = missionState;
         }
+        else
+        {
+            cooperative->setGoal(cooperativeAgent, cKey2);
+        }
+        Vector3 aPos3 = this->sceNode->getPosition();
+        float height = 0.0f;
+        Vector2 aPos2 = Ground::Transfer::to2D(aPos3, height);
+        startMission(new CooperativeFollow(aPos2, cooperative, cooperativeAgent), height);
+    }
 
-        return true;
+    void startMission(PathFollow2 *path, float height)
+    {
+        this->setPath(path);
+        AnimationStateSet *anisSet = entity->getAllAnimationStates();
+
+        // new child state.
+        PathFollow2MissionState *missionState = new PathFollow2MissionState(path, anisSet, aniNames, height);
+        // delete missionState;
+
+        if (this->mission)
+        {
+            //int size = this->children->size();
+            this->removeChild(this->mission);
+            // std::cout << "children:size" << size << ",after remove child size:" << this->children->size() << std::endl;
+
+            delete this->mission;
+        }
+        this->addChild(missionState);
+        this->mission = missionState;
     }
 
     bool frameStarted(const FrameEvent &evt) override
@@ -146,6 +272,31 @@ public:
             }
         };
         this->forEachChild(func);
+        updateOccupancy();
         return true;
     }
+
+    // Moves this actor's mark in the occupancy layer once it enters another cell.
+    void updateOccupancy()
+    {
+        if (!occupancy || !sceNode)
+        {
+            return;
+        }
+        CellKey cell;
+        if (!CellUtil::findCellByPoint(costMap, Ground::Transfer::to2D(sceNode->getPosition()), cell))
+        {
+            return;
+        }
+        if (!occupying)
+        {
+            occupancy->add(cell.first, cell.second);
+            occupying = true;
+        }
+        else
+        {
+            occupancy->move(occupiedCell.first, occupiedCell.second, cell.first, cell.second);
+        }
+        occupiedCell = cell;
+    }
 };
\ No newline at end of file
@@ -45,6 +45,14 @@ public:
         rebuildMarkMesh();
     }
 
+    // Replaces all marks at once with a single mesh rebuild, e.g. by a MovementRange.
+    void setMarks(const std::vector<CellKey> &keys)
+    {
+        marks.clear();
+        marks.insert(keys.begin(), keys.end());
+        rebuildMarkMesh();
+    }
+
     bool isMarked(CellKey key, MarkType mtyp)
     {
         return marks.find(key) != marks.end();
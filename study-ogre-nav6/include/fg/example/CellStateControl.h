@@ -40,11 +40,13 @@ public:
         obj->begin(MaterialNames::materialNameInUse, Ogre::RenderOperation::OT_TRIANGLE_LIST);
         int width = costMap->getWidth();
         int height = costMap->getHeight();
-        for (int x = 0; x < width; x++)
+        const CostLayer costs = costMap->getCostGrid();
+        for (int y = 0; y < height; y++)
         {
-            for (int y = 0; y < height; y++)
+            const uint8_t *row = &costs[costMap->index(0, y)];
+            for (int x = 0; x < width; x++)
             {
-                int cost = costMap->getCost(x, y);
+                int cost = row[x];
                 Ogre::ColourValue color = getCostColor(cost);
                 //auto vertices = CostMap::calculateVerticesForXZ(x, y, CostMap::hexSize);
                 auto vertices = Ground::calculateVertices3D(x, y, CostMap::hexSize);
@@ -3,6 +3,11 @@
 #include "fg/Module.h"
 #include "WorldStateControl.h"
 #include "ExampleGround.h"
+#include "fg/util/PathRequestQueue.h"
+#include "fg/util/FlowField.h"
+#include "fg/util/CostMapComponents.h"
+#include "fg/util/LandmarkHeuristic.h"
+#include "fg/util/CooperativePathfinder.h"
 class Example
 {
 public:
@@ -20,8 +25,40 @@ public:
 
         void active(Core *core) override
         {
-            CostMap *costMap = new CostMapControl(12, 10);
+            CostMap *costMap = CostMapControl::load(COST_MAP_FILE);
             core->setUserObject<CostMap>("costMap", costMap);
+            // lets findPath reject goals walled off from the start without searching
+            core->setUserObject<CostMapComponents>("costMapComponents", new CostMapComponents(costMap));
+
+            // path searches run off the render thread, finished ones are applied per frame
+            PathWorkerPool *pathWorkers = new PathWorkerPool();
+            PathRequestQueue *pathRequests = new PathRequestQueue(costMap, pathWorkers);
+            PathCache *pathCache = new PathCache(costMap);
+            pathRequests->setCache(pathCache);
+            core->setUserObject<PathCache>("pathCache", pathCache);
+            core->setUserObject<PathWorkerPool>("pathWorkers", pathWorkers);
+            // landmark tables are rebuilt once terrain edits settle
+            LandmarkHeuristic *landmarks = new LandmarkHeuristic(costMap, 8, pathWorkers);
+            core->setUserObject<LandmarkHeuristic>("landmarks", landmarks);
+            core->addFrameListener(landmarks);
+            core->setUserObject<PathRequestQueue>("pathRequests", pathRequests);
+            core->addFrameListener(pathRequests);
+            // actors standing on cells, updated as they move; terrain costs stay as they are
+            OccupancyLayer *occupancy = new OccupancyLayer(costMap->getWidth(), costMap->getHeight());
+            core->setUserObject<OccupancyLayer>("occupancy", occupancy);
+#if AVOID_ACTORS
+            costMap->setOccupancy(occupancy);
+            pathCache->setOccupancy(occupancy); // else the cache stands aside
+#endif
+            FlowFieldCache *flowFields = new FlowFieldCache(costMap);
+            core->setUserObject<FlowFieldCache>("flowFields", flowFields);
+#if COOPERATIVE_PATHS
+            // one tick per cell at PathFollow2's default speed
+            CooperativePathfinder *cooperative = new CooperativePathfinder(costMap, flowFields);
+            cooperative->setTickSeconds(2 * CostMap::hexSize / 30.0f);
+            core->setUserObject<CooperativePathfinder>("cooperativePaths", cooperative);
+            core->addFrameListener(cooperative);
+#endif
         }
     };
 
@@ -28,6 +28,8 @@
 #include "fg/util/CellMark.h"
 #include "fg/util/CellUtil.h"
 #include "fg/IWorld.h"
+#include "fg/defines.h"
+#include "fg/util/FlowField.h"
 
 using namespace OgreBites;
 using namespace Ogre;
@@ -88,16 +90,29 @@ public:
 
             if (hitCell)
             {
-
+                // the actors that take this order
+                std::vector<Movable *> movers;
                 core->getRootState()->forEachChild(
-                    [&cKey](State *s)
+                    [&movers](State *s)
                     {
                         Movable *mvb = s->getMovable();
-                        if (mvb)
+                        if (mvb && mvb->isActive())
                         {
-                            mvb->setTargetCell(cKey);
+                            movers.push_back(mvb);
                         }
                     });
+
+                // many movers on one goal: build a single flow field they all follow
+                FlowFieldCache *flowFields = core->getUserObject<FlowFieldCache>("flowFields");
+                if (flowFields && movers.size() >= FLOW_FIELD_MIN_MOVABLES)
+                {
+                    flowFields->get(cKey);
+                }
+
+                for (Movable *mvb : movers)
+                {
+                    mvb->setTargetCell(cKey);
+                }
                 //
             }
             // cout << "worldPoint(" << pickX << ",0," << pickZ << "),cellIdx:[" << cx << "," << cy << "]" << endl;
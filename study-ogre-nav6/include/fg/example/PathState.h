@@ -15,7 +15,7 @@ class PathState : public State
     Ogre::ManualObject *pathObject;
     Ogre::SceneNode *pathNode;
 
-    std::vector<Ogre::Vector2> currentPath;
+    CellPath currentPath;
 
     CostMap *costMap;
     CellKey start = CellKey(-1, -1);
@@ -36,7 +36,7 @@ public:
 
     void clearPath()
     {
-        this->setPath({}, CellKey(-1, -1), CellKey(-1, -1));
+        this->setPath(CellPath(), CellKey(-1, -1), CellKey(-1, -1));
     }
 
     bool getStart(CellKey &start)
@@ -49,7 +49,7 @@ public:
         return true;
     }
 
-    void setPath(const std::vector<Ogre::Vector2> &path, CellKey ck1, CellKey ck2)
+    void setPath(const CellPath &path, CellKey ck1, CellKey ck2)
     {
         currentPath = path;
         start = ck1;
@@ -64,9 +64,9 @@ public:
 
         // Create path points set for quick lookup
         std::unordered_set<std::pair<int, int>, PairHash> pathSet;
-        for (const auto &p : currentPath)
+        for (auto cell : currentPath)
         {
-            pathSet.insert({static_cast<int>(p.x), static_cast<int>(p.y)});
+            pathSet.insert(cell);
         }
 
         // Begin the manual object
@@ -0,0 +1,366 @@
+#pragma once
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <climits>
+#include <algorithm>
+#include <functional>
+#include "CostMap.h"
+
+// When a search has to stop: whichever limit is hit first.
+struct SearchBudget
+{
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    size_t maxExpansions = SIZE_MAX;
+
+    static SearchBudget within(std::chrono::microseconds time, size_t maxExpansions = SIZE_MAX)
+    {
+        SearchBudget budget;
+        budget.deadline = std::chrono::steady_clock::now() + time;
+        budget.maxExpansions = maxExpansions;
+        return budget;
+    }
+};
+
+struct AnytimePathResult
+{
+    std::vector<Ogre::Vector2> path; // empty: no path found (within the budget)
+    int cost = -1;
+    double bound = 0;      // cost <= bound * optimal cost; 1: optimal
+    int solutions = 0;     // improved paths found
+    size_t expanded = 0;
+    bool complete = false; // finished before the budget ran out
+};
+
+// Bounded-suboptimal searches on a CostMap (Likhachev, Gordon, Thrun: ARA*).
+// Weighted A* orders the open list by g + w * h and returns a path costing at
+// most w times the optimum. The anytime mode starts with a large w, then keeps
+// lowering it and repairs the previous search instead of starting over, until
+// the path is proven optimal or the budget runs out; the result is the best path
+// found so far. Its bound is cost / (smallest g + h of any state not yet
+// consistent), which is often well below w.
+// One instance serves one search at a time; arrays are reused between searches.
+class AnytimePathSearch
+{
+    static constexpr int INF = INT_MAX / 4;
+
+    enum : uint8_t
+    {
+        OPEN = 1,
+        CLOSED = 2, // expanded in the current weight pass
+        INCONS = 4  // improved after CLOSED, reopened with the next weight
+    };
+
+    struct Entry
+    {
+        double key;
+        int g;
+        int idx;
+        // ties go to the deeper state, weighted keys tie a lot
+        bool operator>(const Entry &other) const { return key > other.key || (key == other.key && g < other.g); }
+    };
+
+    const CostMap &costMap;
+    std::vector<int> g;
+    std::vector<int> parent;
+    std::vector<uint32_t> stamp; // == generation: g/parent/state valid
+    std::vector<uint8_t> state;
+    std::vector<double> key;
+    std::vector<Entry> heap; // lazy: entries whose key no longer matches are skipped
+    std::vector<int> incons;
+    std::vector<int> closedCells;
+    uint32_t generation = 0;
+
+    int goal = -1;
+    int goalX = 0, goalY = 0;
+    double weight = 1.0;
+    size_t expanded = 0;
+    SearchBudget budget;
+
+public:
+    AnytimePathSearch(const CostMap &costMap) : costMap(costMap)
+    {
+    }
+
+    // Single weighted A* pass: cost <= weight * optimal.
+    bool findPathWeighted(int startX, int startY, int endX, int endY, double weight, AnytimePathResult &result,
+                          const SearchBudget &budget = SearchBudget())
+    {
+        return run(startX, startY, endX, endY, weight, 0.0, budget, result);
+    }
+
+    // ARA*: first path with initialWeight, then weight lowered by weightStep per pass.
+    bool findPathAnytime(int startX, int startY, int endX, int endY, const SearchBudget &budget, AnytimePathResult &result,
+                         double initialWeight = 3.0, double weightStep = 0.5)
+    {
+        return run(startX, startY, endX, endY, initialWeight, weightStep, budget, result);
+    }
+
+private:
+    bool run(int startX, int startY, int endX, int endY, double initialWeight, double weightStep,
+             const SearchBudget &searchBudget, AnytimePathResult &result)
+    {
+        result = AnytimePathResult();
+        if (!costMap.isWalkable(startX, startY) || !costMap.isWalkable(endX, endY))
+        {
+            result.complete = true;
+            return false;
+        }
+        reset();
+        budget = searchBudget;
+        goal = costMap.index(endX, endY);
+        goalX = endX;
+        goalY = endY;
+        weight = std::max(1.0, initialWeight);
+        expanded = 0;
+
+        const int start = costMap.index(startX, startY);
+        touch(goal);
+        touch(start);
+        g[start] = 0;
+        open(start);
+
+        for (;;)
+        {
+            bool finished = improvePath();
+            result.expanded = expanded;
+            if (!finished)
+            {
+                // budget ran out mid-pass: only the previous pass's bound is proven
+                int cost = result.solutions > 0 ? chainCost() : INF;
+                if (cost < result.cost)
+                {
+                    result.bound = std::max(1.0, result.bound * cost / result.cost);
+                    publish(result);
+                }
+                return !result.path.empty();
+            }
+            if (g[goal] >= INF)
+            {
+                result.complete = true; // open list ran dry: no path
+                return false;
+            }
+
+            // any cheaper path has to pass a state that is open or inconsistent
+            const int cost = chainCost();
+            double lowest = lowerBound();
+            double bound = std::min(weight, lowest > 0 ? cost / lowest : 1.0);
+            if (result.solutions > 0)
+            {
+                bound = std::min(bound, result.bound * cost / result.cost);
+            }
+            result.bound = std::max(1.0, bound);
+            if (result.solutions == 0 || cost < result.cost)
+            {
+                publish(result);
+            }
+            if (result.bound <= 1.0 || weightStep <= 0.0)
+            {
+                result.complete = true;
+                return true;
+            }
+            weight = std::max(1.0, std::min(weight - weightStep, result.bound));
+            reopen();
+        }
+    }
+
+    // The parent chain may already be cheaper than g[goal] if states on it
+    // improved after the goal was reached; its own cost is what counts.
+    int chainCost() const
+    {
+        const CostLayer grid = costMap.getCostGrid();
+        int cost = 0;
+        for (int idx = goal; parent[idx] != -1; idx = parent[idx])
+        {
+            cost += grid[idx];
+        }
+        return cost;
+    }
+
+    void publish(AnytimePathResult &result) const
+    {
+        result.cost = chainCost();
+        result.solutions++;
+        extractPath(result.path);
+    }
+
+    void reset()
+    {
+        const size_t cells = costMap.getCostGrid().size();
+        if (stamp.size() != cells)
+        {
+            g.assign(cells, INF);
+            parent.assign(cells, -1);
+            stamp.assign(cells, 0);
+            state.assign(cells, 0);
+            key.assign(cells, 0.0);
+            generation = 0;
+        }
+        if (++generation == 0)
+        {
+            std::fill(stamp.begin(), stamp.end(), 0);
+            generation = 1;
+        }
+        heap.clear();
+        incons.clear();
+        closedCells.clear();
+    }
+
+    void touch(int idx)
+    {
+        if (stamp[idx] != generation)
+        {
+            stamp[idx] = generation;
+            g[idx] = INF;
+            parent[idx] = -1;
+            state[idx] = 0;
+        }
+    }
+
+    int h(int idx) const
+    {
+        return CostMap::hexDistance(costMap.cellX(idx), costMap.cellY(idx), goalX, goalY) * CostMap::DEFAULT_COST;
+    }
+
+    void open(int idx)
+    {
+        open(idx, h(idx));
+    }
+
+    void open(int idx, int hValue)
+    {
+        state[idx] |= OPEN;
+        key[idx] = g[idx] + weight * hValue;
+        heap.push_back({key[idx], g[idx], idx});
+        std::push_heap(heap.begin(), heap.end(), std::greater<Entry>());
+    }
+
+    // Drop stale heap entries; false when no open state is left.
+    bool settleTop()
+    {
+        while (!heap.empty())
+        {
+            const Entry &top = heap.front();
+            if ((state[top.idx] & OPEN) && key[top.idx] == top.key)
+            {
+                return true;
+            }
+            std::pop_heap(heap.begin(), heap.end(), std::greater<Entry>());
+            heap.pop_back();
+        }
+        return false;
+    }
+
+    bool outOfBudget() const
+    {
+        if (expanded >= budget.maxExpansions)
+        {
+            return true;
+        }
+        // the clock is comparatively slow, look at it every 64 expansions
+        return (expanded & 63) == 0 && std::chrono::steady_clock::now() >= budget.deadline;
+    }
+
+    // One weight pass; false if the budget ran out first.
+    bool improvePath()
+    {
+        const CostLayer grid = costMap.getCostGrid();
+        while (settleTop() && g[goal] > heap.front().key)
+        {
+            if (outOfBudget())
+            {
+                return false;
+            }
+            const int u = heap.front().idx;
+            std::pop_heap(heap.begin(), heap.end(), std::greater<Entry>());
+            heap.pop_back();
+            state[u] = (state[u] & ~OPEN) | CLOSED;
+            closedCells.push_back(u);
+            expanded++;
+
+            const int ux = costMap.cellX(u);
+            const int uy = costMap.cellY(u);
+            const int *delta = costMap.getNeighborDeltas(uy);
+            for (int i = 0; i < 6; i++)
+            {
+                const int v = u + delta[i];
+                if (grid[v] <= 0)
+                    continue;
+                touch(v);
+                const int tentativeG = g[u] + grid[v];
+                if (tentativeG < g[v])
+                {
+                    g[v] = tentativeG;
+                    parent[v] = u;
+                    if (!(state[v] & CLOSED))
+                    {
+                        auto [vx, vy] = costMap.getNeighbor(ux, uy, i);
+                        open(v, CostMap::hexDistance(vx, vy, goalX, goalY) * CostMap::DEFAULT_COST);
+                    }
+                    else if (!(state[v] & INCONS))
+                    {
+                        state[v] |= INCONS;
+                        incons.push_back(v);
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    double lowerBound()
+    {
+        double lowest = g[goal];
+        for (const Entry &e : heap)
+        {
+            if ((state[e.idx] & OPEN) && key[e.idx] == e.key)
+            {
+                lowest = std::min(lowest, static_cast<double>(g[e.idx] + h(e.idx)));
+            }
+        }
+        for (int idx : incons)
+        {
+            lowest = std::min(lowest, static_cast<double>(g[idx] + h(idx)));
+        }
+        return lowest;
+    }
+
+    // Next pass: inconsistent states join the open list, everything is keyed
+    // with the new weight and nothing counts as expanded yet.
+    void reopen()
+    {
+        std::vector<Entry> old;
+        old.swap(heap);
+        for (const Entry &e : old)
+        {
+            if ((state[e.idx] & OPEN) && key[e.idx] == e.key)
+            {
+                open(e.idx);
+            }
+        }
+        for (int idx : incons)
+        {
+            if (!(state[idx] & OPEN))
+            {
+                open(idx);
+            }
+            state[idx] &= ~INCONS;
+        }
+        incons.clear();
+        for (int idx : closedCells)
+        {
+            state[idx] &= ~CLOSED;
+        }
+        closedCells.clear();
+    }
+
+    void extractPath(std::vector<Ogre::Vector2> &path) const
+    {
+        path.clear();
+        for (int idx = goal; idx != -1; idx = parent[idx])
+        {
+            path.push_back(Ogre::Vector2(static_cast<float>(costMap.cellX(idx)), static_cast<float>(costMap.cellY(idx))));
+        }
+        std::reverse(path.begin(), path.end());
+    }
+};
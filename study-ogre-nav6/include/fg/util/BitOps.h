@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// 64-bit word helpers for bit masks laid out one bit per cell.
+class BitOps
+{
+public:
+    static int popcount(uint64_t v)
+    {
+#ifdef _MSC_VER
+        return static_cast<int>(__popcnt64(v));
+#else
+        return __builtin_popcountll(v);
+#endif
+    }
+
+    // Index of the lowest set bit; v must not be 0.
+    static int lowestBit(uint64_t v)
+    {
+#ifdef _MSC_VER
+        unsigned long i;
+        _BitScanForward64(&i, v);
+        return static_cast<int>(i);
+#else
+        return __builtin_ctzll(v);
+#endif
+    }
+
+    // Bits [from, to) set, 0 <= from <= to <= 64.
+    static uint64_t range(int from, int to)
+    {
+        uint64_t upTo = to >= 64 ? ~uint64_t(0) : (uint64_t(1) << to) - 1;
+        return upTo & ~((uint64_t(1) << from) - 1);
+    }
+};
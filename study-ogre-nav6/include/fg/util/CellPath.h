@@ -0,0 +1,252 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <OgreVector2.h>
+#include "HexCoord.h"
+
+// Path of hex cells stored as its start cell plus one 3-bit direction code
+// per step (21 codes per 64-bit word), about 3/8 byte per cell instead of
+// the 8 of an Ogre::Vector2. Directions are those of CostMap::getNeighbor().
+// Cells are decoded on the fly by the iterators; map() adapts them further,
+// e.g. to world-space centres, without building a second array.
+class CellPath
+{
+    static constexpr int CODES_PER_WORD = 21;
+
+    int startX = -1, startY = -1;
+    int endX = -1, endY = -1;
+    uint32_t steps = 0;
+    std::vector<uint64_t> words;
+
+public:
+    static void step(int &x, int &y, int direction)
+    {
+        x += Hex::OFFSET_DX[y & 1][direction];
+        y += Hex::OFFSET_DY[direction];
+    }
+
+    // Direction from a cell to an adjacent one, -1 if they are not adjacent.
+    static int directionTo(int x, int y, int nx, int ny)
+    {
+        return Hex::directionTo(Hex::toAxial(x, y), Hex::toAxial(nx, ny));
+    }
+
+    class Iterator
+    {
+        const CellPath *path;
+        uint32_t pos;
+        int x, y;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<int, int>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type *;
+        using reference = value_type;
+
+        Iterator(const CellPath *path, uint32_t pos, int x, int y) : path(path), pos(pos), x(x), y(y)
+        {
+        }
+
+        std::pair<int, int> operator*() const
+        {
+            return {x, y};
+        }
+
+        Iterator &operator++()
+        {
+            if (pos < path->steps)
+            {
+                step(x, y, path->direction(pos));
+            }
+            pos++;
+            return *this;
+        }
+
+        bool operator==(const Iterator &other) const { return pos == other.pos; }
+        bool operator!=(const Iterator &other) const { return pos != other.pos; }
+    };
+
+    // Cells passed through f one at a time.
+    template <typename F>
+    class MappedRange
+    {
+        const CellPath *path;
+        F f;
+
+    public:
+        class MappedIterator
+        {
+            Iterator it;
+            F f;
+
+        public:
+            MappedIterator(Iterator it, F f) : it(it), f(f) {}
+            auto operator*() const { return f(*it); }
+            MappedIterator &operator++()
+            {
+                ++it;
+                return *this;
+            }
+            bool operator==(const MappedIterator &other) const { return it == other.it; }
+            bool operator!=(const MappedIterator &other) const { return it != other.it; }
+        };
+
+        MappedRange(const CellPath *path, F f) : path(path), f(f) {}
+        MappedIterator begin() const { return MappedIterator(path->begin(), f); }
+        MappedIterator end() const { return MappedIterator(path->end(), f); }
+    };
+
+    CellPath()
+    {
+    }
+
+    // From a chain of cells; each element has x, y members (Ogre::Vector2).
+    // Cells that are not adjacent are joined by a straight line, see extendTo().
+    explicit CellPath(const std::vector<Ogre::Vector2> &cells)
+    {
+        assign(cells);
+    }
+
+    void clear()
+    {
+        startX = startY = endX = endY = -1;
+        steps = 0;
+        words.clear();
+    }
+
+    bool empty() const
+    {
+        return startX < 0;
+    }
+
+    // Number of cells, start included.
+    size_t size() const
+    {
+        return empty() ? 0 : steps + 1;
+    }
+
+    std::pair<int, int> front() const
+    {
+        return {startX, startY};
+    }
+
+    std::pair<int, int> back() const
+    {
+        return {endX, endY};
+    }
+
+    int direction(uint32_t i) const
+    {
+        return static_cast<int>((words[i / CODES_PER_WORD] >> (3 * (i % CODES_PER_WORD))) & 7);
+    }
+
+    void start(int x, int y)
+    {
+        clear();
+        startX = endX = x;
+        startY = endY = y;
+    }
+
+    // Extend the path by one step from its last cell.
+    void push(int direction)
+    {
+        if (steps % CODES_PER_WORD == 0)
+        {
+            words.push_back(0);
+        }
+        words.back() |= static_cast<uint64_t>(direction) << (3 * (steps % CODES_PER_WORD));
+        steps++;
+        step(endX, endY, direction);
+    }
+
+    // Extend the path to (x, y): one step if adjacent to the last cell, else
+    // through the cells of Hex::line() in between; nothing if it is the last cell.
+    void extendTo(int x, int y)
+    {
+        const int d = directionTo(endX, endY, x, y);
+        if (d >= 0)
+        {
+            push(d);
+            return;
+        }
+        Hex::line(endX, endY, x, y, [this](int cx, int cy)
+                  {
+            if (cx != endX || cy != endY)
+            {
+                push(directionTo(endX, endY, cx, cy));
+            } });
+    }
+
+    void assign(const std::vector<Ogre::Vector2> &cells)
+    {
+        clear();
+        if (cells.empty())
+        {
+            return;
+        }
+        words.reserve((cells.size() - 1 + CODES_PER_WORD - 1) / CODES_PER_WORD);
+        start(static_cast<int>(cells[0].x), static_cast<int>(cells[0].y));
+        for (size_t i = 1; i < cells.size(); i++)
+        {
+            extendTo(static_cast<int>(cells[i].x), static_cast<int>(cells[i].y));
+        }
+    }
+
+    // From linear cell indices laid out like CostMap::costGrid (padded, stride = width + 2).
+    void assign(const std::vector<int> &chain, int stride)
+    {
+        clear();
+        if (chain.empty())
+        {
+            return;
+        }
+        words.reserve((chain.size() - 1 + CODES_PER_WORD - 1) / CODES_PER_WORD);
+        start(chain[0] % stride - 1, chain[0] / stride - 1);
+        for (size_t i = 1; i < chain.size(); i++)
+        {
+            extendTo(chain[i] % stride - 1, chain[i] / stride - 1);
+        }
+    }
+
+    // The cells as Ogre::Vector2, the form of the vector overloads of CostMap::findPath.
+    std::vector<Ogre::Vector2> toVectors() const
+    {
+        std::vector<Ogre::Vector2> cells;
+        cells.reserve(size());
+        for (auto cell : *this)
+        {
+            cells.push_back(Ogre::Vector2(static_cast<float>(cell.first), static_cast<float>(cell.second)));
+        }
+        return cells;
+    }
+
+    Iterator begin() const
+    {
+        return Iterator(this, 0, startX, startY);
+    }
+
+    Iterator end() const
+    {
+        return Iterator(this, static_cast<uint32_t>(size()), endX, endY);
+    }
+
+    template <typename F>
+    MappedRange<F> map(F f) const
+    {
+        return MappedRange<F>(this, f);
+    }
+
+    size_t getBytes() const
+    {
+        return sizeof(CellPath) + words.capacity() * sizeof(uint64_t);
+    }
+
+    bool operator==(const CellPath &other) const
+    {
+        return startX == other.startX && startY == other.startY && steps == other.steps && words == other.words;
+    }
+};
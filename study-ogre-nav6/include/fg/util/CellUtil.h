@@ -8,7 +8,22 @@
 class CellUtil
 {
 public:
-    static void translatePathToCellCenter(std::vector<Vector2> &pathByKey, std::vector<Vector2> &pathByPosition)
+    // World-space centre of a cell, for CellPath::map().
+    struct CellCenter
+    {
+        Vector2 operator()(std::pair<int, int> cell) const
+        {
+            return Ground::calculateCenter(cell.first, cell.second, CostMap::hexSize);
+        }
+    };
+
+    // Centres of the path's cells, computed while iterating.
+    static CellPath::MappedRange<CellCenter> cellCenters(const CellPath &path)
+    {
+        return path.map(CellCenter());
+    }
+
+    static void translatePathToCellCenter(const std::vector<Vector2> &pathByKey, std::vector<Vector2> &pathByPosition)
     {
         for (int i = 0; i < pathByKey.size(); i++)
         {
@@ -0,0 +1,375 @@
+#pragma once
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+#include <queue>
+#include <climits>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <OgreFrameListener.h>
+#include "CostMap.h"
+#include "CostMapFile.h"
+
+// World map too large to keep in memory: square chunks of chunkSize cells,
+// each a CostMap stored as its own CostMapFile (chunk_<cx>_<cy>.hxcm in the
+// world directory) and mapped in on first access. At most maxResident chunks
+// stay resident; the least recently used one goes first, written back only if
+// setCost() changed it. A chunk without a file comes from the generator, or
+// is all DEFAULT_COST without one.
+//
+// Cells use world coordinates throughout. As a FrameListener it keeps the
+// chunks around every focus (actors, the camera) resident ahead of use.
+// Not thread safe: even getCost() may load and evict chunks.
+class ChunkedCostMap : public Ogre::FrameListener
+{
+public:
+    using Generator = std::function<void(int chunkX, int chunkY, CostMap &chunk)>;
+    using Focus = std::function<CellKey()>;
+
+private:
+    struct Chunk
+    {
+        std::unique_ptr<CostMap> map;
+        bool dirty = false;
+        std::list<int64_t>::iterator lru;
+    };
+
+    struct OpenNode
+    {
+        int f, g;
+        int x, y;
+        bool operator>(const OpenNode &other) const { return f > other.f || (f == other.f && g < other.g); }
+    };
+
+    struct SearchNode
+    {
+        int g;
+        int64_t parent;
+        bool closed;
+    };
+
+    std::string directory;
+    int width, height;
+    int chunkSize;
+    int chunksX, chunksY;
+    size_t maxResident;
+    Generator generator;
+    std::vector<Focus> foci;
+    int prefetchRadius = 1; // chunks around each focus
+
+    std::unordered_map<int64_t, Chunk> resident;
+    std::list<int64_t> lru; // front: most recently used
+    int64_t lastKey = -1;   // one-entry cache in front of the hash lookup
+    CostMap *lastMap = nullptr;
+    size_t loads = 0, writes = 0;
+
+public:
+    ChunkedCostMap(const std::string &directory, int width, int height, int chunkSize = 256, size_t maxResident = 64,
+                   Generator generator = nullptr)
+        : directory(directory), width(width), height(height), chunkSize(chunkSize),
+          chunksX((width + chunkSize - 1) / chunkSize), chunksY((height + chunkSize - 1) / chunkSize),
+          maxResident(std::max<size_t>(maxResident, 1)), generator(generator)
+    {
+    }
+
+    ~ChunkedCostMap()
+    {
+        flush();
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getChunkSize() const { return chunkSize; }
+    size_t getResidentCount() const { return resident.size(); }
+    size_t getLoadCount() const { return loads; }
+    size_t getWriteCount() const { return writes; }
+
+    bool isResident(int chunkX, int chunkY) const
+    {
+        return resident.count(key(chunkX, chunkY)) > 0;
+    }
+
+    int getCost(int x, int y)
+    {
+        if (x < 0 || x >= width || y < 0 || y >= height)
+            return CostMap::OBSTACLE;
+        return chunkFor(x, y).getCost(x % chunkSize, y % chunkSize);
+    }
+
+    bool isWalkable(int x, int y)
+    {
+        return getCost(x, y) > CostMap::OBSTACLE;
+    }
+
+    void setCost(int x, int y, int cost)
+    {
+        if (x < 0 || x >= width || y < 0 || y >= height)
+            return;
+        CostMap &map = chunkFor(x, y);
+        if (map.getCost(x % chunkSize, y % chunkSize) != cost)
+        {
+            map.setCost(x % chunkSize, y % chunkSize, cost);
+            resident[key(x / chunkSize, y / chunkSize)].dirty = true;
+        }
+    }
+
+    // === Residency ===
+    void addFocus(Focus focus)
+    {
+        foci.push_back(focus);
+    }
+
+    void setPrefetchRadius(int chunks)
+    {
+        this->prefetchRadius = chunks;
+    }
+
+    // Loads the chunks within radius chunks of cell (x, y); the cell's own chunk ends up most recent.
+    void prefetch(int x, int y, int radius)
+    {
+        const int cx = x / chunkSize;
+        const int cy = y / chunkSize;
+        for (int dy = -radius; dy <= radius; dy++)
+        {
+            for (int dx = -radius; dx <= radius; dx++)
+            {
+                if ((dx != 0 || dy != 0) && inWorld(cx + dx, cy + dy))
+                {
+                    chunk(cx + dx, cy + dy);
+                }
+            }
+        }
+        if (inWorld(cx, cy))
+        {
+            chunk(cx, cy);
+        }
+    }
+
+    bool frameStarted(const Ogre::FrameEvent &/*evt*/) override
+    {
+        for (Focus &focus : foci)
+        {
+            CellKey cell = focus();
+            prefetch(cell.first, cell.second, prefetchRadius);
+        }
+        return true;
+    }
+
+    // Writes back every modified chunk; all stay resident.
+    bool flush()
+    {
+        bool ok = true;
+        for (auto &entry : resident)
+        {
+            if (entry.second.dirty)
+            {
+                ok = writeBack(entry.first, entry.second) && ok;
+            }
+        }
+        return ok;
+    }
+
+    // === Path finding across chunks ===
+    // A* over world cells with hex distance; per-cell state is hashed, not
+    // dense, since the world may not fit in memory. Chunks are paged as the
+    // search reaches them. maxExpanded bounds the work for unreachable goals.
+    bool findPath(int startX, int startY, int endX, int endY, CellPath &path, size_t maxExpanded = SIZE_MAX)
+    {
+        path.clear();
+        if (!isWalkable(startX, startY) || !isWalkable(endX, endY))
+        {
+            return false;
+        }
+        std::unordered_map<int64_t, SearchNode> nodes;
+        std::priority_queue<OpenNode, std::vector<OpenNode>, std::greater<OpenNode>> open;
+        const int64_t startKey = key(startX, startY);
+        const int64_t endKey = key(endX, endY);
+        nodes[startKey] = {0, -1, false};
+        open.push({Hex::distance(startX, startY, endX, endY) * CostMap::DEFAULT_COST, 0, startX, startY});
+        size_t expanded = 0;
+        while (!open.empty())
+        {
+            OpenNode current = open.top();
+            open.pop();
+            const int64_t currKey = key(current.x, current.y);
+            SearchNode &node = nodes[currKey];
+            if (node.closed || current.g != node.g)
+                continue;
+            node.closed = true;
+            if (currKey == endKey)
+            {
+                extractPath(nodes, endKey, path);
+                return true;
+            }
+            if (++expanded > maxExpanded)
+            {
+                return false;
+            }
+            for (int d = 0; d < 6; d++)
+            {
+                auto [nx, ny] = Hex::neighbor(current.x, current.y, d);
+                const int cost = getCost(nx, ny);
+                if (cost <= CostMap::OBSTACLE)
+                    continue;
+                const int g = current.g + cost;
+                auto inserted = nodes.emplace(key(nx, ny), SearchNode{g, currKey, false});
+                SearchNode &next = inserted.first->second;
+                if (!inserted.second)
+                {
+                    if (next.closed || g >= next.g)
+                        continue;
+                    next.g = g;
+                    next.parent = currKey;
+                }
+                open.push({g + Hex::distance(nx, ny, endX, endY) * CostMap::DEFAULT_COST, g, nx, ny});
+            }
+        }
+        return false;
+    }
+
+    int calculatePathCost(const CellPath &path)
+    {
+        int cost = 0;
+        bool first = true;
+        for (auto cell : path)
+        {
+            if (!first)
+            {
+                cost += getCost(cell.first, cell.second);
+            }
+            first = false;
+        }
+        return cost;
+    }
+
+private:
+    static int64_t key(int x, int y)
+    {
+        return (static_cast<int64_t>(y) << 32) | static_cast<uint32_t>(x);
+    }
+
+    static int keyX(int64_t k)
+    {
+        return static_cast<int32_t>(k & 0xFFFFFFFF);
+    }
+
+    static int keyY(int64_t k)
+    {
+        return static_cast<int>(k >> 32);
+    }
+
+    bool inWorld(int chunkX, int chunkY) const
+    {
+        return chunkX >= 0 && chunkX < chunksX && chunkY >= 0 && chunkY < chunksY;
+    }
+
+    std::string chunkPath(int chunkX, int chunkY) const
+    {
+        return directory + "/chunk_" + std::to_string(chunkX) + "_" + std::to_string(chunkY) + ".hxcm";
+    }
+
+    CostMap &chunkFor(int x, int y)
+    {
+        return chunk(x / chunkSize, y / chunkSize);
+    }
+
+    // Resident chunk, loaded (and something else evicted) if needed.
+    CostMap &chunk(int chunkX, int chunkY)
+    {
+        const int64_t k = key(chunkX, chunkY);
+        if (k == lastKey)
+        {
+            return *lastMap;
+        }
+        auto it = resident.find(k);
+        if (it == resident.end())
+        {
+            while (resident.size() >= maxResident)
+            {
+                evict(lru.back());
+            }
+            it = resident.emplace(k, Chunk()).first;
+            it->second.map = load(chunkX, chunkY);
+            lru.push_front(k);
+        }
+        else
+        {
+            lru.splice(lru.begin(), lru, it->second.lru);
+        }
+        it->second.lru = lru.begin();
+        lastKey = k;
+        lastMap = it->second.map.get();
+        return *lastMap;
+    }
+
+    std::unique_ptr<CostMap> load(int chunkX, int chunkY)
+    {
+        loads++;
+        MappedCostLayer layer;
+        if (CostMapFile::open(chunkPath(chunkX, chunkY), layer) && layer.width == chunkSize &&
+            layer.height == chunkSize)
+        {
+            return std::unique_ptr<CostMap>(new CostMap(layer));
+        }
+        std::unique_ptr<CostMap> map(new CostMap(chunkSize, chunkSize));
+        if (generator)
+        {
+            generator(chunkX, chunkY, *map);
+        }
+        return map;
+    }
+
+    void evict(int64_t k)
+    {
+        auto it = resident.find(k);
+        if (it->second.dirty)
+        {
+            writeBack(k, it->second);
+        }
+        lru.erase(it->second.lru);
+        resident.erase(it);
+        if (k == lastKey)
+        {
+            lastKey = -1;
+            lastMap = nullptr;
+        }
+    }
+
+    bool writeBack(int64_t k, Chunk &chunk)
+    {
+        // switch to an owned copy first: the file is about to be replaced,
+        // and some platforms refuse to replace a file that is still mapped
+        if (chunk.map->isMapped())
+        {
+            chunk.map.reset(new CostMap(*chunk.map));
+            if (k == lastKey)
+            {
+                lastMap = chunk.map.get();
+            }
+        }
+        if (!CostMapFile::save(*chunk.map, chunkPath(keyX(k), keyY(k)), 0))
+        {
+            return false;
+        }
+        chunk.dirty = false;
+        writes++;
+        return true;
+    }
+
+    void extractPath(const std::unordered_map<int64_t, SearchNode> &nodes, int64_t endKey, CellPath &path) const
+    {
+        std::vector<int64_t> cells;
+        for (int64_t k = endKey; k != -1; k = nodes.at(k).parent)
+        {
+            cells.push_back(k);
+        }
+        path.start(keyX(cells.back()), keyY(cells.back()));
+        for (size_t i = cells.size() - 1; i-- > 0;)
+        {
+            auto [x, y] = path.back();
+            path.push(CellPath::directionTo(x, y, keyX(cells[i]), keyY(cells[i])));
+        }
+    }
+};
@@ -0,0 +1,326 @@
+#pragma once
+#include <vector>
+#include <queue>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include <OgreFrameListener.h>
+#include "CostMap.h"
+#include "FlowField.h"
+#include "ReservationTable.h"
+
+// Windowed hierarchical cooperative A* (Silver, "Cooperative Pathfinding").
+// Agents move one cell, or wait, per tick. Each plans window ticks ahead in
+// (cell, tick) space around the cells other agents have reserved, then
+// reserves its own plan; plans are redone every replanInterval ticks, spread
+// over the agents so only a share of them searches on any one tick. Swaps
+// (two agents trading cells in one tick) are ruled out as well.
+// The heuristic is the true cost to the goal ignoring other agents, read
+// from the goal's FlowField, so agents beyond the window still head the
+// right way. As a FrameListener it steps once per tickSeconds.
+class CooperativePathfinder : public Ogre::FrameListener
+{
+    struct Agent
+    {
+        bool alive = false;
+        int cell;
+        int goal;
+        std::shared_ptr<const FlowField> field;
+        std::vector<int> plan; // cell at tick planTick + i
+        int planTick = 0;
+    };
+
+    struct Node
+    {
+        int cell;
+        int dt;
+        int g;
+        int parent; // position in nodes
+    };
+
+    struct OpenEntry
+    {
+        int f, g, dt, node;
+        bool operator>(const OpenEntry &other) const
+        {
+            return f > other.f || (f == other.f && (dt < other.dt || (dt == other.dt && g < other.g)));
+        }
+    };
+
+    const CostMap &costMap;
+    FlowFieldCache *fields;
+    std::unique_ptr<FlowFieldCache> ownFields;
+    ReservationTable table;
+    int window;
+    int replanInterval;
+    float tickSeconds = 2.0f;
+    float sinceTick = 0.0f;
+    int tick = 0;
+    std::vector<Agent> agents;
+    std::vector<int> freeIds;
+
+    // search scratch
+    std::vector<Node> nodes;
+    std::unordered_map<int64_t, int> nodeOf; // (cell, dt) -> position in nodes
+    std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> open;
+    size_t searches = 0, expanded = 0;
+
+public:
+    // fields: shared cache of goal fields (e.g. Example's "flowFields"), null for an own one.
+    CooperativePathfinder(CostMap *costMap, FlowFieldCache *fields = nullptr, int window = 16, int replanInterval = 8,
+                          size_t agentsHint = 256)
+        : costMap(*costMap), fields(fields), table(std::min(window, 255) + 1, agentsHint),
+          window(std::min(window, 255)), // dt has 8 bits in a search key
+          replanInterval(std::max(1, std::min(replanInterval, window)))
+    {
+        if (!this->fields)
+        {
+            ownFields.reset(new FlowFieldCache(costMap, 64));
+            this->fields = ownFields.get();
+        }
+    }
+
+    void setTickSeconds(float seconds)
+    {
+        this->tickSeconds = seconds;
+    }
+
+    int getTick() const
+    {
+        return tick;
+    }
+
+    size_t getSearchCount() const { return searches; }
+    size_t getExpandedCount() const { return expanded; }
+
+    // New agent standing on start; -1 if start is not walkable.
+    int addAgent(CellKey start, CellKey goal)
+    {
+        if (!costMap.isWalkable(start.first, start.second))
+        {
+            return -1;
+        }
+        int id;
+        if (!freeIds.empty())
+        {
+            id = freeIds.back();
+            freeIds.pop_back();
+        }
+        else
+        {
+            id = static_cast<int>(agents.size());
+            agents.emplace_back();
+        }
+        Agent &a = agents[id];
+        a.alive = true;
+        a.cell = costMap.index(start.first, start.second);
+        a.plan.clear();
+        setGoal(id, goal);
+        return id;
+    }
+
+    void removeAgent(int id)
+    {
+        Agent &a = agents[id];
+        unreserve(id);
+        a.alive = false;
+        a.field.reset();
+        freeIds.push_back(id);
+    }
+
+    // New goal, planned for at once.
+    void setGoal(int id, CellKey goal)
+    {
+        Agent &a = agents[id];
+        a.goal = costMap.index(goal.first, goal.second);
+        a.field = fields->get(goal);
+        replan(id);
+    }
+
+    CellKey getCell(int id) const
+    {
+        return {costMap.cellX(agents[id].cell), costMap.cellY(agents[id].cell)};
+    }
+
+    // Cell the agent will occupy after ticksAhead more ticks, as far as planned.
+    CellKey getPlannedCell(int id, int ticksAhead) const
+    {
+        const Agent &a = agents[id];
+        int i = tick + ticksAhead - a.planTick;
+        if (a.plan.empty() || i < 0)
+        {
+            return getCell(id);
+        }
+        int cell = a.plan[std::min(i, static_cast<int>(a.plan.size()) - 1)];
+        return {costMap.cellX(cell), costMap.cellY(cell)};
+    }
+
+    bool isAtGoal(int id) const
+    {
+        return agents[id].cell == agents[id].goal;
+    }
+
+    bool frameStarted(const Ogre::FrameEvent &evt) override
+    {
+        sinceTick += evt.timeSinceLastFrame;
+        while (sinceTick >= tickSeconds)
+        {
+            sinceTick -= tickSeconds;
+            step();
+        }
+        return true;
+    }
+
+    // One tick: every agent moves to its next planned cell, then the agents
+    // due for it replan.
+    void step()
+    {
+        tick++;
+        table.advance(tick);
+        for (Agent &a : agents)
+        {
+            if (a.alive && !a.plan.empty())
+            {
+                int i = tick - a.planTick;
+                a.cell = a.plan[std::min(i, static_cast<int>(a.plan.size()) - 1)];
+            }
+        }
+        for (int id = 0; id < static_cast<int>(agents.size()); id++)
+        {
+            Agent &a = agents[id];
+            if (!a.alive)
+                continue;
+            const int planned = static_cast<int>(a.plan.size()) - 1 - (tick - a.planTick);
+            if (planned < window - replanInterval || (tick + id) % replanInterval == 0)
+            {
+                replan(id);
+            }
+        }
+    }
+
+private:
+    static int64_t key(int cell, int dt)
+    {
+        return (static_cast<int64_t>(cell) << 8) | dt;
+    }
+
+    void unreserve(int id)
+    {
+        Agent &a = agents[id];
+        for (size_t i = 0; i < a.plan.size(); i++)
+        {
+            table.release(a.plan[i], a.planTick + static_cast<int>(i), id);
+        }
+        a.plan.clear();
+    }
+
+    void replan(int id)
+    {
+        unreserve(id);
+        Agent &a = agents[id];
+        a.planTick = tick;
+        search(id, a.plan);
+        for (size_t i = 0; i < a.plan.size(); i++)
+        {
+            table.reserve(a.plan[i], tick + static_cast<int>(i), id);
+        }
+    }
+
+    int h(const Agent &a, int cell) const
+    {
+        int c = a.field->getCostToGoal(costMap.cellX(cell), costMap.cellY(cell));
+        return c < 0 ? 0 : c;
+    }
+
+    // May agent id step from u (at tick t) into v (at t + 1)?
+    bool canMove(int id, int u, int v, int t) const
+    {
+        if (!table.isFree(v, t + 1, id))
+        {
+            return false;
+        }
+        if (u == v)
+        {
+            return true;
+        }
+        // whoever is in v now must not be moving into u
+        int other = table.holder(v, t);
+        return other < 0 || other == id || table.holder(u, t + 1) != other;
+    }
+
+    // Space-time A* to the window's edge; plan gets one cell per tick from now.
+    void search(int id, std::vector<int> &plan)
+    {
+        const Agent &a = agents[id];
+        const CostLayer grid = costMap.getCostGrid();
+        searches++;
+        nodes.clear();
+        nodeOf.clear();
+        open = decltype(open)();
+        plan.clear();
+        if (a.field->getCostToGoal(costMap.cellX(a.cell), costMap.cellY(a.cell)) < 0)
+        {
+            plan.assign(window + 1, a.cell); // goal unreachable: stay put
+            return;
+        }
+
+        nodes.push_back({a.cell, 0, 0, -1});
+        nodeOf[key(a.cell, 0)] = 0;
+        open.push({h(a, a.cell), 0, 0, 0});
+        int found = -1;
+        while (!open.empty())
+        {
+            OpenEntry e = open.top();
+            open.pop();
+            const Node n = nodes[e.node];
+            if (e.g != n.g)
+                continue; // improved since
+            expanded++;
+            if (n.dt == window)
+            {
+                found = e.node;
+                break;
+            }
+            const int t = tick + n.dt;
+            const int *delta = costMap.getNeighborDeltas(costMap.cellY(n.cell));
+            for (int i = -1; i < 6; i++)
+            {
+                const int v = i < 0 ? n.cell : n.cell + delta[i];
+                // waiting on the goal is free, so a parked agent only moves to make way
+                const int cost = i >= 0 ? grid[v] : (v == a.goal ? 0 : CostMap::DEFAULT_COST);
+                if ((i >= 0 && cost <= 0) || !canMove(id, n.cell, v, t))
+                    continue;
+                const int g = n.g + cost;
+                const int64_t k = key(v, n.dt + 1);
+                auto it = nodeOf.find(k);
+                if (it != nodeOf.end() && nodes[it->second].g <= g)
+                    continue;
+                int pos;
+                if (it == nodeOf.end())
+                {
+                    pos = static_cast<int>(nodes.size());
+                    nodes.push_back({v, n.dt + 1, g, e.node});
+                    nodeOf[k] = pos;
+                }
+                else
+                {
+                    pos = it->second;
+                    nodes[pos].g = g;
+                    nodes[pos].parent = e.node;
+                }
+                open.push({g + h(a, v), g, n.dt + 1, pos});
+            }
+        }
+
+        if (found < 0)
+        {
+            plan.assign(window + 1, a.cell); // boxed in for now: hold the cell until the next replan
+            return;
+        }
+        for (int p = found; p != -1; p = nodes[p].parent)
+        {
+            plan.push_back(nodes[p].cell);
+        }
+        std::reverse(plan.begin(), plan.end());
+    }
+};
@@ -9,6 +9,9 @@
 #include <utility>
 #include <algorithm>
 #include <functional>
+#include <climits>
+#include <cstdint>
+#include <memory>
 
 // === Include OgreBites for modern initialization ===
 #include <Bites/OgreApplicationContext.h>
@@ -24,6 +27,14 @@
 #include <OgreRTShaderSystem.h>
 #include <OgreTechnique.h>
 #include "CellMark.h"
+#include "PathSearchContext.h"
+#include "CellPath.h"
+#include "HexCoord.h"
+#include "BitOps.h"
+#include "MappedFile.h"
+#include "GoalBuckets.h"
+#include "GridSearch.h"
+#include "OccupancyLayer.h"
 
 struct PairHash
 {
@@ -36,13 +47,38 @@ struct PairHash
     }
 };
 
-// === NavNode structure ===
-struct NavNode
+// Read-only view of a CostMap's padded cost cells, see CostMap::index().
+class CostLayer
 {
-    int x, y;
-    float g, h;
-    float f() const { return g + h; }
-    bool operator>(const NavNode &other) const { return f() > other.f(); }
+    const uint8_t *cells;
+    size_t count;
+
+public:
+    CostLayer(const uint8_t *cells, size_t count) : cells(cells), count(count)
+    {
+    }
+
+    const uint8_t &operator[](size_t idx) const { return cells[idx]; }
+    const uint8_t *data() const { return cells; }
+    size_t size() const { return count; }
+};
+
+// Per-query search strategy of CostMap::findPath.
+enum class PathSearchMode
+{
+    FORWARD,      // A* from the start
+    BIDIRECTIONAL // A* from both ends, meets in the middle; for long routes
+};
+
+// Cost cells and walkable mask of a map inside a mapped file, laid out exactly
+// as CostMap keeps them in memory; see CostMapFile::open().
+struct MappedCostLayer
+{
+    std::shared_ptr<MappedFile> file;
+    size_t costOffset = 0; // padded cost cells
+    size_t maskOffset = 0; // walkable mask words, 8-byte aligned
+    int width = 0, height = 0;
+    int maxCost = 1;
 };
 
 class CostMap
@@ -51,30 +87,196 @@ public:
     static constexpr float hexSize = 30.0f; // inner radius
 
 private:
-    // === Fixed hexagon neighbor offsets (flat-top) ===
-    int dx_even[6] = {+1, 0, -1, -1, -1, 0};
-    int dy_even[6] = {0, -1, -1, 0, +1, +1};
-    int dx_odd[6] = {+1, +1, 0, -1, 0, +1};
-    int dy_odd[6] = {0, -1, -1, 0, +1, +1};
+    // Hex neighbour offsets as linear deltas into costGrid, by row parity.
+    std::array<std::array<int, 6>, 2> neighborDelta;
+    // Storage behind costGrid and walkableMask: either owned, or a mapped file
+    // whose pages setCost() copies on first write.
+    std::vector<uint8_t> ownedCells;
+    std::vector<uint64_t> ownedMask;
+    std::shared_ptr<MappedFile> mapping;
 
 public:
-    std::vector<std::vector<int>> costGrid;
+    // Row-major cost cells with a one-cell OBSTACLE border on every side,
+    // so any neighbour of an in-map cell is addressable without bounds checks.
+    // One byte per cell: a 4096 x 4096 map takes 16 MB instead of 64.
+    uint8_t *costGrid;
+    size_t cellCount; // stride * (height + 2)
+    // One bit per cell, set if walkable: row y is words [y * maskStride, (y + 1) * maskStride),
+    // cell x is bit x % 64 of word x / 64. Not padded; bits past width are 0.
+    uint64_t *walkableMask;
+    int maskStride;
     int width, height;
+    int stride; // width + 2
+    int maxCost = DEFAULT_COST; // upper bound of any cell cost, never lowered
 
 public:
-    static const int OBSTACLE = 0;
-    static const int DEFAULT_COST = 1;
+    static constexpr int OBSTACLE = 0;
+    static constexpr int DEFAULT_COST = 1;
+    static constexpr int MAX_COST = 255; // setCost() clamps to [OBSTACLE, MAX_COST]
+
+    // Notified by setCost() after a cell cost actually changed.
+    class Listener
+    {
+    public:
+        virtual void costChanged(int x, int y, int oldCost, int newCost) = 0;
+    };
+
+    // Optional O(1) test consulted by findPath before searching, see CostMapComponents.
+    class Reachability
+    {
+    public:
+        virtual bool isReachable(int fromIdx, int toIdx) const = 0;
+    };
+
+    // Optional replacement for the hex-distance bound of the forward search, see
+    // LandmarkHeuristic. Must be consistent and never overestimate the cost to the goal.
+    class Heuristic
+    {
+    public:
+        virtual int estimate(int idx, int goalIdx) const = 0;
+
+        // Taken once per search: a non-null result answers that search's
+        // estimates instead, so the heuristic can swap its data while
+        // searches on other threads are running.
+        virtual std::shared_ptr<const Heuristic> snapshot() const
+        {
+            return nullptr;
+        }
+    };
+
+protected:
+    std::vector<CostMap::Listener *> listeners;
+    const CostMap::Reachability *reachability = nullptr;
+    const CostMap::Heuristic *goalHeuristic = nullptr;
+    const OccupancyLayer *occupancy = nullptr;
+
+public:
+
+    CostMap(int w, int h) : maskStride((w + 63) / 64), width(w), height(h), stride(w + 2)
+    {
+        cellCount = static_cast<size_t>(stride) * (height + 2);
+        ownedCells.assign(cellCount, OBSTACLE);
+        ownedMask.assign(static_cast<size_t>(maskStride) * height, 0);
+        costGrid = ownedCells.data();
+        walkableMask = ownedMask.data();
+        for (int y = 0; y < height; y++)
+        {
+            std::fill_n(costGrid + index(0, y), width, DEFAULT_COST);
+            uint64_t *row = &walkableMask[static_cast<size_t>(y) * maskStride];
+            for (int word = 0; word < maskStride; word++)
+            {
+                row[word] = BitOps::range(0, std::min(64, width - word * 64));
+            }
+        }
+        neighborDelta = Hex::linearDeltas(stride);
+    }
+
+    // Wraps a map file as is, nothing is parsed or copied.
+    CostMap(const MappedCostLayer &layer)
+        : mapping(layer.file), maskStride((layer.width + 63) / 64), width(layer.width), height(layer.height),
+          stride(layer.width + 2), maxCost(layer.maxCost)
+    {
+        cellCount = static_cast<size_t>(stride) * (height + 2);
+        costGrid = mapping->data() + layer.costOffset;
+        walkableMask = reinterpret_cast<uint64_t *>(mapping->data() + layer.maskOffset);
+        neighborDelta = Hex::linearDeltas(stride);
+    }
+
+    // Copies the cells into owned storage; listeners and hooks stay with the original.
+    CostMap(const CostMap &other)
+        : neighborDelta(other.neighborDelta),
+          ownedCells(other.costGrid, other.costGrid + other.cellCount),
+          ownedMask(other.walkableMask, other.walkableMask + static_cast<size_t>(other.maskStride) * other.height),
+          costGrid(ownedCells.data()), cellCount(other.cellCount), walkableMask(ownedMask.data()),
+          maskStride(other.maskStride), width(other.width), height(other.height), stride(other.stride),
+          maxCost(other.maxCost)
+    {
+    }
+
+    CostMap &operator=(const CostMap &) = delete;
+
+    // True if the cells live in a mapped file.
+    bool isMapped() const
+    {
+        return mapping != nullptr;
+    }
+
+    // Linear index of (x, y) in costGrid; valid for -1 <= x <= width, -1 <= y <= height.
+    int index(int x, int y) const
+    {
+        return (y + 1) * stride + (x + 1);
+    }
+
+    // Cell coordinates of a linear index.
+    int cellX(int idx) const
+    {
+        return idx % stride - 1;
+    }
+
+    int cellY(int idx) const
+    {
+        return idx / stride - 1;
+    }
 
-    CostMap(int w, int h) : width(w), height(h)
+    // Linear costGrid deltas of the 6 neighbours of a cell in row y, same order as getNeighbor().
+    const int *getNeighborDeltas(int y) const
     {
-        costGrid.resize(height, std::vector<int>(width, DEFAULT_COST));
+        return neighborDelta[y & 1].data();
+    }
+
+    void addListener(CostMap::Listener *l)
+    {
+        listeners.push_back(l);
+    }
+
+    void removeListener(CostMap::Listener *l)
+    {
+        listeners.erase(std::remove(listeners.begin(), listeners.end(), l), listeners.end());
+    }
+
+    void setReachability(const CostMap::Reachability *r)
+    {
+        this->reachability = r;
+    }
+
+    void setHeuristic(const CostMap::Heuristic *h)
+    {
+        this->goalHeuristic = h;
+    }
+
+    // Units to path around, null to ignore them. Searches treat blocked cells
+    // as obstacles, except their start and goal cells; findReachable() never
+    // ends on one. Must be sized like this map.
+    void setOccupancy(const OccupancyLayer *o)
+    {
+        this->occupancy = o;
+    }
+
+    const OccupancyLayer *getOccupancy() const
+    {
+        return occupancy;
     }
 
     void setCost(int x, int y, int cost)
     {
         if (x >= 0 && x < width && y >= 0 && y < height)
         {
-            costGrid[y][x] = cost;
+            cost = std::min(std::max(cost, OBSTACLE), MAX_COST);
+            uint8_t &cell = costGrid[index(x, y)];
+            int oldCost = cell;
+            if (oldCost == cost)
+            {
+                return;
+            }
+            cell = static_cast<uint8_t>(cost);
+            maxCost = std::max(maxCost, cost);
+            uint64_t &word = walkableMask[static_cast<size_t>(y) * maskStride + (x >> 6)];
+            const uint64_t bit = uint64_t(1) << (x & 63);
+            word = cost > OBSTACLE ? word | bit : word & ~bit;
+            for (CostMap::Listener *l : listeners)
+            {
+                l->costChanged(x, y, oldCost, cost);
+            }
         }
     }
 
@@ -82,127 +284,444 @@ public:
     {
         if (x < 0 || x >= width || y < 0 || y >= height)
             return OBSTACLE;
-        return costGrid[y][x];
+        return costGrid[index(x, y)];
     }
 
     bool isWalkable(int x, int y) const
     {
-        return getCost(x, y) > 0;
+        if (x < 0 || x >= width || y < 0 || y >= height)
+            return false;
+        return (walkableMask[static_cast<size_t>(y) * maskStride + (x >> 6)] >> (x & 63)) & 1;
     }
 
-    std::pair<int, int> getNeighbor(int x, int y, int direction) const
+    // === Walkable mask, 64 cells per word ===
+    // Words of row y, cell x at bit x % 64 of word x / 64.
+    const uint64_t *getWalkableRow(int y) const
     {
-        if (direction < 0 || direction >= 6)
-            return {x, y};
-        if (y % 2 == 0)
+        return &walkableMask[static_cast<size_t>(y) * maskStride];
+    }
+
+    int getMaskStride() const { return maskStride; }
+
+    // Walkable cells in the rectangle [x0, x1] x [y0, y1], clipped to the map.
+    int countWalkable(int x0, int y0, int x1, int y1) const
+    {
+        int count = 0;
+        forEachRegionWord(x0, y0, x1, y1, [&count](uint64_t bits, uint64_t mask)
+                          { count += BitOps::popcount(bits & mask); return true; });
+        return count;
+    }
+
+    // True if every cell of [x0, x1] x [y0, y1] is inside the map and walkable.
+    bool isRegionWalkable(int x0, int y0, int x1, int y1) const
+    {
+        if (x0 < 0 || y0 < 0 || x1 >= width || y1 >= height)
+            return false;
+        return forEachRegionWord(x0, y0, x1, y1, [](uint64_t bits, uint64_t mask)
+                                 { return (bits & mask) == mask; });
+    }
+
+    bool anyWalkable(int x0, int y0, int x1, int y1) const
+    {
+        return !forEachRegionWord(x0, y0, x1, y1, [](uint64_t bits, uint64_t mask)
+                                  { return (bits & mask) == 0; });
+    }
+
+    // Calls f(firstX, lastX) for each maximal run of walkable cells in row y, left to right.
+    template <typename F>
+    void forEachWalkableRun(int y, F f) const
+    {
+        const uint64_t *row = getWalkableRow(y);
+        int runStart = -1;
+        for (int word = 0; word < maskStride; word++)
         {
-            return {x + dx_even[direction], y + dy_even[direction]};
+            const uint64_t bits = row[word];
+            int pos = 0;
+            while (pos < 64)
+            {
+                // look for the next set bit outside a run, the next clear one inside
+                const uint64_t rest = (runStart < 0 ? bits : ~bits) >> pos;
+                if (rest == 0)
+                    break;
+                pos += BitOps::lowestBit(rest);
+                if (runStart < 0)
+                {
+                    runStart = word * 64 + pos;
+                }
+                else
+                {
+                    f(runStart, word * 64 + pos - 1);
+                    runStart = -1;
+                }
+            }
         }
-        else
+        if (runStart >= 0)
         {
-            return {x + dx_odd[direction], y + dy_odd[direction]};
+            f(runStart, width - 1);
         }
     }
 
-    float heuristic(int x1, int y1, int x2, int y2) const
+    std::pair<int, int> getNeighbor(int x, int y, int direction) const
     {
-        int q1 = x1 - (y1 - (y1 & 1)) / 2;
-        int r1 = y1;
-        int s1 = -q1 - r1;
-
-        int q2 = x2 - (y2 - (y2 & 1)) / 2;
-        int r2 = y2;
-        int s2 = -q2 - r2;
+        if (direction < 0 || direction >= 6)
+            return {x, y};
+        return Hex::neighbor(x, y, direction);
+    }
 
-        int dq = abs(q1 - q2);
-        int dr = abs(r1 - r2);
-        int ds = abs(s1 - s2);
+    float heuristic(int x1, int y1, int x2, int y2) const
+    {
+        return static_cast<float>(hexDistance(x1, y1, x2, y2) * DEFAULT_COST);
+    }
 
-        return static_cast<float>(std::max({dq, dr, ds}) * DEFAULT_COST);
+    static constexpr int hexDistance(int x1, int y1, int x2, int y2)
+    {
+        return Hex::distance(x1, y1, x2, y2);
     }
 
-    std::vector<Ogre::Vector2> findPath(CellKey start, CellKey end)
+    std::vector<Ogre::Vector2> findPath(CellKey start, CellKey end) const
     {
         return findPath(start.first, start.second, end.first, end.second);
     }
 
-    std::vector<Ogre::Vector2> findPath(int startX, int startY, int endX, int endY)
+    std::vector<Ogre::Vector2> findPath(int startX, int startY, int endX, int endY) const
     {
-        using Pos = std::pair<int, int>;
+        return findPath(startX, startY, endX, endY, PathSearchContext::local());
+    }
 
-        if (!isWalkable(startX, startY) || !isWalkable(endX, endY))
+    std::vector<Ogre::Vector2> findPath(int startX, int startY, int endX, int endY, PathSearchContext &ctx,
+                                        PathSearchMode mode = PathSearchMode::FORWARD) const
+    {
+        std::vector<Ogre::Vector2> path;
+        findPath(startX, startY, endX, endY, ctx, path, mode);
+        return path;
+    }
+
+    // Writes the path into `path` (cleared first, capacity reused); false if there is none.
+    bool findPath(int startX, int startY, int endX, int endY, PathSearchContext &ctx, std::vector<Ogre::Vector2> &path,
+                  PathSearchMode mode = PathSearchMode::FORWARD) const
+    {
+        path.clear();
+        if (!search(startX, startY, endX, endY, ctx, mode))
+        {
+            return false;
+        }
+        path.reserve(ctx.chain.size());
+        for (int idx : ctx.chain)
         {
-            return {};
+            path.push_back(Ogre::Vector2(static_cast<float>(cellX(idx)), static_cast<float>(cellY(idx))));
         }
+        return true;
+    }
 
-        std::priority_queue<NavNode, std::vector<NavNode>, std::greater<NavNode>> openList;
-        std::unordered_map<Pos, Pos, PairHash> cameFrom;
-        std::unordered_map<Pos, float, PairHash> gScore;
-        std::unordered_set<Pos, PairHash> closed;
+    // Same, as the compact CellPath that stored paths should use.
+    bool findPath(int startX, int startY, int endX, int endY, PathSearchContext &ctx, CellPath &path,
+                  PathSearchMode mode = PathSearchMode::FORWARD) const
+    {
+        if (!search(startX, startY, endX, endY, ctx, mode))
+        {
+            path.clear();
+            return false;
+        }
+        path.assign(ctx.chain, stride);
+        return true;
+    }
 
-        NavNode start = {startX, startY, 0, heuristic(startX, startY, endX, endY)};
-        openList.push(start);
-        gScore[{startX, startY}] = 0;
+    // Runs the search only; on success ctx.chain holds the path's cell indices, start first.
+    // ctx.stats holds the counters of the search afterwards, both directions summed.
+    bool search(int startX, int startY, int endX, int endY, PathSearchContext &ctx,
+                PathSearchMode mode = PathSearchMode::FORWARD) const
+    {
+        ctx.chain.clear();
+        if (!isWalkable(startX, startY) || !isWalkable(endX, endY))
+        {
+            return false;
+        }
+        if (reachability && !reachability->isReachable(index(startX, startY), index(endX, endY)))
+        {
+            return false; // walled off, nothing to search
+        }
+        if (mode == PathSearchMode::BIDIRECTIONAL)
+        {
+            return searchBidirectional(startX, startY, endX, endY, ctx);
+        }
 
-        while (!openList.empty())
+        // f grows by at most moveCost + DEFAULT_COST per step, see BucketOpenList;
+        // a consistent custom heuristic may rise by up to the cost of the cell left
+        const int endIdx = index(endX, endY);
+        const uint8_t *grid = costGrid;
+        auto cost = [this, grid, endIdx](int, int to, int)
+        {
+            const int c = grid[to];
+            return c > 0 && isOccupied(to, endIdx) ? 0 : c;
+        };
+        if (goalHeuristic)
         {
-            NavNode current = openList.top();
-            openList.pop();
-            Pos currPos = {current.x, current.y};
+            const std::shared_ptr<const Heuristic> pinned = goalHeuristic->snapshot();
+            const Heuristic *heuristic = pinned ? pinned.get() : goalHeuristic;
+            auto h = [heuristic, endIdx](int, int, int idx)
+            { return heuristic->estimate(idx, endIdx); };
+            return GridSearch::findPath<HexTopology>(stride, cellCount, startX, startY, endX, endY, cost, h,
+                                                     2 * maxCost, ctx);
+        }
+        const HexAxial goal = Hex::toAxial(endX, endY); // converted once, not per neighbour
+        auto h = [goal](int x, int y, int)
+        { return Hex::distance(Hex::toAxial(x, y), goal) * DEFAULT_COST; };
+        return GridSearch::findPath<HexTopology>(stride, cellCount, startX, startY, endX, endY, cost, h,
+                                                 maxCost + DEFAULT_COST, ctx);
+    }
 
-            if (closed.find(currPos) != closed.end())
+    // Multi-goal search: one A* from (startX, startY) that stops at the first
+    // goal it reaches, which is the cheapest one. The heuristic is the hex
+    // distance to the nearest goal, looked up through GoalBuckets. goal receives
+    // the goal reached. Goals that are not walkable, or walled off from the
+    // start (see setReachability), are skipped up front.
+    bool findPathToNearest(int startX, int startY, const std::vector<CellKey> &goals, PathSearchContext &ctx,
+                           CellPath &path, CellKey &goal) const
+    {
+        path.clear();
+        ctx.chain.clear();
+        if (!isWalkable(startX, startY))
+        {
+            return false;
+        }
+        const int startIdx = index(startX, startY);
+        std::vector<CellKey> targets;
+        std::vector<int> targetIdx; // sorted, for the goal test on every pop
+        for (const CellKey &g : goals)
+        {
+            if (isWalkable(g.first, g.second) &&
+                (!reachability || reachability->isReachable(startIdx, index(g.first, g.second))))
+            {
+                targets.push_back(g);
+                targetIdx.push_back(index(g.first, g.second));
+            }
+        }
+        if (targets.empty())
+        {
+            return false;
+        }
+        std::sort(targetIdx.begin(), targetIdx.end());
+        GoalBuckets buckets;
+        buckets.assign(targets);
+
+        // min of consistent heuristics is consistent, same step bound as search()
+        ctx.reset(cellCount, maxCost + DEFAULT_COST);
+        ctx.push({startX, startY, 0, buckets.nearest(startX, startY) * DEFAULT_COST, startIdx});
+        ctx.visit(startIdx, 0, -1);
+        while (!ctx.open.empty())
+        {
+            NavNode current = ctx.pop();
+            const int currIdx = current.idx;
+            if (ctx.isClosed(currIdx))
                 continue;
-            closed.insert(currPos);
+            ctx.close(currIdx);
 
-            if (current.x == endX && current.y == endY)
+            if (std::binary_search(targetIdx.begin(), targetIdx.end(), currIdx))
             {
-                return reconstructPath(cameFrom, currPos);
+                reconstructPath(ctx, currIdx, ctx.chain);
+                path.assign(ctx.chain, stride);
+                goal = {current.x, current.y};
+                return true;
             }
 
+            const int currG = ctx.gScore[currIdx];
+            const int *delta = neighborDelta[current.y & 1].data();
             for (int i = 0; i < 6; i++)
             {
-                auto [nx, ny] = getNeighbor(current.x, current.y, i);
-                if (!isWalkable(nx, ny))
+                const int nIdx = currIdx + delta[i];
+                const int moveCost = costGrid[nIdx];
+                if (moveCost <= 0 || ctx.isClosed(nIdx))
+                    continue;
+                // a goal may well be a unit's cell, e.g. the nearest enemy
+                if (occupancy && occupancy->isBlocked(nIdx) &&
+                    !std::binary_search(targetIdx.begin(), targetIdx.end(), nIdx))
                     continue;
+                const int g = currG + moveCost;
+                const bool seen = ctx.isVisited(nIdx);
+                if (!seen || g < ctx.gScore[nIdx])
+                {
+                    const int oldG = ctx.gScore[nIdx];
+                    ctx.visit(nIdx, g, currIdx);
+                    auto [nx, ny] = getNeighbor(current.x, current.y, i);
+                    const int h = buckets.nearest(nx, ny) * DEFAULT_COST;
+                    if (seen)
+                        ctx.decrease({nx, ny, g, h, nIdx}, oldG + h);
+                    else
+                        ctx.push({nx, ny, g, h, nIdx});
+                }
+            }
+        }
+        return false;
+    }
 
-                Pos neighbor = {nx, ny};
-                int moveCost = getCost(nx, ny);
-                float tentativeG = gScore[currPos] + moveCost;
+    // Movement range: every cell reachable from (x, y) for a total cost of at
+    // most budget, by Dijkstra that never steps past the budget. Afterwards
+    // ctx.chain lists the cells in order of cost, (x, y) first, and for each
+    // of them ctx.gScore / ctx.parent hold its cost and predecessor.
+    // Returns the number of cells, 0 if (x, y) is not walkable.
+    size_t findReachable(int x, int y, int budget, PathSearchContext &ctx) const
+    {
+        ctx.chain.clear();
+        if (!isWalkable(x, y) || budget < 0)
+        {
+            return 0;
+        }
+        ctx.reset(cellCount, maxCost);
+        const int originIdx = index(x, y);
+        ctx.push({x, y, 0, 0, originIdx});
+        ctx.visit(originIdx, 0, -1);
+        while (!ctx.open.empty())
+        {
+            NavNode current = ctx.pop();
+            const int currIdx = current.idx;
+            if (ctx.isClosed(currIdx))
+                continue;
+            ctx.close(currIdx);
+            ctx.chain.push_back(currIdx);
 
-                auto it = gScore.find(neighbor);
-                if (it == gScore.end() || tentativeG < it->second)
+            const int currG = ctx.gScore[currIdx];
+            const int *delta = neighborDelta[current.y & 1].data();
+            for (int i = 0; i < 6; i++)
+            {
+                const int nIdx = currIdx + delta[i];
+                const int moveCost = costGrid[nIdx];
+                if (moveCost <= 0 || currG + moveCost > budget || ctx.isClosed(nIdx) ||
+                    (occupancy && occupancy->isBlocked(nIdx)))
+                    continue;
+                const int g = currG + moveCost;
+                const bool seen = ctx.isVisited(nIdx);
+                if (!seen || g < ctx.gScore[nIdx])
                 {
-                    cameFrom[neighbor] = currPos;
-                    gScore[neighbor] = tentativeG;
-                    float h = heuristic(nx, ny, endX, endY);
-
-                    NavNode node = {nx, ny, tentativeG, h};
-                    openList.push(node);
+                    const int oldG = ctx.gScore[nIdx];
+                    ctx.visit(nIdx, g, currIdx);
+                    auto [nx, ny] = getNeighbor(current.x, current.y, i);
+                    if (seen)
+                        ctx.decrease({nx, ny, g, 0, nIdx}, oldG);
+                    else
+                        ctx.push({nx, ny, g, 0, nIdx});
                 }
             }
         }
+        return ctx.chain.size();
+    }
 
-        return {};
+    // Path to a cell of the range found last by findReachable() with ctx.
+    bool findPathInReach(const PathSearchContext &ctx, int x, int y, CellPath &path) const
+    {
+        path.clear();
+        if (x < 0 || x >= width || y < 0 || y >= height || !ctx.isClosed(index(x, y)))
+        {
+            return false;
+        }
+        std::vector<int> chain;
+        reconstructPath(ctx, index(x, y), chain);
+        path.assign(chain, stride);
+        return true;
     }
 
 private:
-    std::vector<Ogre::Vector2> reconstructPath(
-        const std::unordered_map<std::pair<int, int>, std::pair<int, int>, PairHash> &cameFrom,
-        const std::pair<int, int> &current) const
+    // Blocked by a unit, and not the cell the search is heading for.
+    bool isOccupied(int idx, int targetIdx) const
     {
+        return occupancy && idx != targetIdx && occupancy->isBlocked(idx);
+    }
 
-        std::vector<Ogre::Vector2> path;
-        std::pair<int, int> node = current;
+    // Both searches run on the average potential p(v) = (hEnd(v) - hStart(v)) / 2
+    // (doubled to stay integral), which keeps edge costs non-negative in both
+    // directions. Then the usual bidirectional Dijkstra rule applies: once the
+    // two smallest keys together reach the best meeting cost, no shorter path
+    // is left. Keys are offset by the start-end distance to stay >= 0.
+    // Always uses hex distance; a Heuristic set on the map applies to FORWARD only.
+    bool searchBidirectional(int startX, int startY, int endX, int endY, PathSearchContext &fwd) const
+    {
+        PathSearchContext &bwd = fwd.reverse();
+        const int maxStep = 2 * (maxCost + DEFAULT_COST);
+        fwd.reset(cellCount, maxStep);
+        bwd.reset(cellCount, maxStep);
+        const int startIdx = index(startX, startY);
+        const int endIdx = index(endX, endY);
+        const HexAxial startAxial = Hex::toAxial(startX, startY);
+        const HexAxial endAxial = Hex::toAxial(endX, endY);
+        const int dist = Hex::distance(startAxial, endAxial) * DEFAULT_COST;
+
+        fwd.push({startX, startY, 0, 2 * dist, startIdx});
+        fwd.visit(startIdx, 0, -1);
+        bwd.push({endX, endY, 0, 2 * dist, endIdx});
+        bwd.visit(endIdx, 0, -1);
+        int best = startIdx == endIdx ? 0 : INT_MAX;
+        int meet = startIdx == endIdx ? startIdx : -1;
+
+        while (!fwd.open.empty() && !bwd.open.empty())
+        {
+            const int keyF = fwd.open.minF();
+            const int keyB = bwd.open.minF();
+            if (meet >= 0 && keyF + keyB >= 2 * (best + dist))
+                break;
+
+            const bool forward = keyF <= keyB;
+            PathSearchContext &ctx = forward ? fwd : bwd;
+            const PathSearchContext &other = forward ? bwd : fwd;
+            NavNode current = ctx.pop();
+            const int currIdx = current.idx;
+            if (ctx.isClosed(currIdx))
+                continue;
+            ctx.close(currIdx);
+
+            const int currG = ctx.gScore[currIdx];
+            const int *delta = neighborDelta[current.y & 1].data();
+            for (int i = 0; i < 6; i++)
+            {
+                const int nIdx = currIdx + delta[i];
+                if (costGrid[nIdx] <= 0 || ctx.isClosed(nIdx) || isOccupied(nIdx, forward ? endIdx : startIdx))
+                    continue;
 
-        while (cameFrom.find(node) != cameFrom.end())
+                // backwards the step runs from the neighbour into current
+                int tentativeG = currG + (forward ? costGrid[nIdx] : costGrid[currIdx]);
+                bool seen = ctx.isVisited(nIdx);
+                if (!seen || tentativeG < ctx.gScore[nIdx])
+                {
+                    int oldG = ctx.gScore[nIdx];
+                    ctx.visit(nIdx, tentativeG, currIdx);
+                    auto [nx, ny] = getNeighbor(current.x, current.y, i);
+                    const HexAxial n = Hex::toAxial(nx, ny);
+                    int toStart = Hex::distance(n, startAxial) * DEFAULT_COST;
+                    int toEnd = Hex::distance(n, endAxial) * DEFAULT_COST;
+                    int h = (forward ? toEnd - toStart : toStart - toEnd) + dist;
+                    if (seen)
+                        ctx.decrease({nx, ny, 2 * tentativeG, h, nIdx}, 2 * oldG + h);
+                    else
+                        ctx.push({nx, ny, 2 * tentativeG, h, nIdx});
+
+                    if (other.isVisited(nIdx) && tentativeG + other.gScore[nIdx] < best)
+                    {
+                        best = tentativeG + other.gScore[nIdx];
+                        meet = nIdx;
+                    }
+                }
+            }
+        }
+
+        fwd.stats.add(bwd.stats);
+        if (meet < 0)
+        {
+            return false;
+        }
+        reconstructPath(fwd, meet, fwd.chain);
+        for (int idx = bwd.parent[meet]; idx != -1; idx = bwd.parent[idx])
         {
-            path.push_back(Ogre::Vector2(static_cast<float>(node.first), static_cast<float>(node.second)));
-            node = cameFrom.at(node);
+            fwd.chain.push_back(idx);
         }
-        path.push_back(Ogre::Vector2(static_cast<float>(node.first), static_cast<float>(node.second)));
+        return true;
+    }
 
-        std::reverse(path.begin(), path.end());
-        return path;
+    void reconstructPath(const PathSearchContext &ctx, int current, std::vector<int> &chain) const
+    {
+        for (int idx = current; idx != -1; idx = ctx.parent[idx])
+        {
+            chain.push_back(idx);
+        }
+
+        std::reverse(chain.begin(), chain.end());
     }
 
 public:
@@ -218,11 +737,49 @@ public:
         return totalCost;
     }
 
+    float calculatePathCost(const CellPath &path) const
+    {
+        float totalCost = 0;
+        bool first = true;
+        for (auto cell : path)
+        {
+            if (!first)
+                totalCost += getCost(cell.first, cell.second);
+            first = false;
+        }
+        return totalCost;
+    }
+
     // === Data interface for Ogre rendering ===
-    const std::vector<std::vector<int>> &getCostGrid() const { return costGrid; }
+    // Padded row-major buffer, see index(); border cells are OBSTACLE.
+    CostLayer getCostGrid() const { return CostLayer(costGrid, cellCount); }
     int getWidth() const { return width; }
     int getHeight() const { return height; }
+    int getStride() const { return stride; }
 
 private:
-   
+    // Calls f(bits, mask) on each mask word overlapping the clipped rectangle,
+    // mask selecting its cells; stops early and returns false once f does.
+    template <typename F>
+    bool forEachRegionWord(int x0, int y0, int x1, int y1, F f) const
+    {
+        x0 = std::max(x0, 0);
+        y0 = std::max(y0, 0);
+        x1 = std::min(x1, width - 1);
+        y1 = std::min(y1, height - 1);
+        for (int y = y0; y <= y1; y++)
+        {
+            const uint64_t *row = getWalkableRow(y);
+            for (int word = x0 >> 6; word <= x1 >> 6; word++)
+            {
+                const int from = std::max(x0 - word * 64, 0);
+                const int to = std::min(x1 - word * 64 + 1, 64);
+                if (!f(row[word], BitOps::range(from, to)))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
 };
\ No newline at end of file
@@ -0,0 +1,288 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include "CostMap.h"
+
+// Connected components of the walkable cells, kept current on every setCost().
+// Registered as the map's Reachability, so findPath() to a goal walled off from
+// the start fails in O(1) instead of flooding the start's whole component.
+//
+// A cell becoming walkable joins its neighbours' components; the smaller ones are
+// relabelled into the largest. A cell becoming an obstacle only needs work when
+// its walkable neighbours do not form one contiguous arc around it (otherwise
+// they stay connected through each other); then just that component is relabelled.
+// Labels are indexed like CostMap::costGrid, -1 for obstacles and the border.
+class CostMapComponents : public CostMap::Listener, public CostMap::Reachability
+{
+    static constexpr int NONE = -1;
+
+    CostMap *costMap;
+    std::vector<int> label;
+    std::vector<int> size; // cells per label, 0: free
+    std::vector<int> freeLabels;
+    std::vector<int> queue; // flood scratch
+    int count = 0;
+
+public:
+    CostMapComponents(CostMap *costMap) : costMap(costMap)
+    {
+        rebuild();
+        costMap->addListener(this);
+        costMap->setReachability(this);
+    }
+
+    ~CostMapComponents()
+    {
+        costMap->setReachability(nullptr);
+        costMap->removeListener(this);
+    }
+
+    // Label every cell from scratch. Works on runs of walkable cells taken from
+    // the map's walkable mask a word at a time: runs touching one in the row
+    // above are joined (union-find), then each run is painted with its label.
+    void rebuild()
+    {
+        label.assign(costMap->getCostGrid().size(), NONE);
+        size.clear();
+        freeLabels.clear();
+        count = 0;
+
+        std::vector<Run> runs;
+        std::vector<int> parent;
+        size_t prevBegin = 0, prevEnd = 0;
+        for (int y = 0; y < costMap->getHeight(); y++)
+        {
+            // cells above x are x - 1 and x in even rows, x and x + 1 in odd ones
+            const int shift = Hex::isShifted(y) ? 1 : 0;
+            const size_t begin = runs.size();
+            size_t above = prevBegin;
+            costMap->forEachWalkableRun(y, [&](int first, int last)
+                                        {
+                const int id = static_cast<int>(runs.size());
+                runs.push_back({y, first, last});
+                parent.push_back(id);
+                const int lo = first - 1 + shift;
+                const int hi = last + shift;
+                while (above < prevEnd && runs[above].last < lo)
+                {
+                    above++;
+                }
+                for (size_t r = above; r < prevEnd && runs[r].first <= hi; r++)
+                {
+                    unite(parent, id, static_cast<int>(r));
+                } });
+            prevBegin = begin;
+            prevEnd = runs.size();
+        }
+
+        std::vector<int> rootLabel(runs.size(), NONE);
+        for (size_t r = 0; r < runs.size(); r++)
+        {
+            const int root = find(parent, static_cast<int>(r));
+            if (rootLabel[root] == NONE)
+            {
+                rootLabel[root] = newLabel();
+            }
+            const int l = rootLabel[root];
+            const Run &run = runs[r];
+            std::fill_n(label.begin() + costMap->index(run.first, run.y), run.last - run.first + 1, l);
+            size[l] += run.last - run.first + 1;
+        }
+    }
+
+    int getComponentCount() const
+    {
+        return count;
+    }
+
+    // Component of a cell, -1 for obstacles and cells outside the map.
+    int getComponent(int x, int y) const
+    {
+        if (x < 0 || x >= costMap->getWidth() || y < 0 || y >= costMap->getHeight())
+        {
+            return NONE;
+        }
+        return label[costMap->index(x, y)];
+    }
+
+    int getComponentSize(int component) const
+    {
+        return component < 0 ? 0 : size[component];
+    }
+
+    bool isReachable(CellKey a, CellKey b) const
+    {
+        int l = getComponent(a.first, a.second);
+        return l != NONE && l == getComponent(b.first, b.second);
+    }
+
+    bool isReachable(int fromIdx, int toIdx) const override
+    {
+        return label[fromIdx] != NONE && label[fromIdx] == label[toIdx];
+    }
+
+    const std::vector<int> &getLabels() const
+    {
+        return label;
+    }
+
+    void costChanged(int x, int y, int oldCost, int newCost) override
+    {
+        if ((oldCost > 0) == (newCost > 0))
+        {
+            return; // walkability unchanged
+        }
+        int idx = costMap->index(x, y);
+        if (newCost > 0)
+        {
+            addCell(idx);
+        }
+        else
+        {
+            removeCell(idx);
+        }
+    }
+
+private:
+    struct Run
+    {
+        int y, first, last;
+    };
+
+    static int find(std::vector<int> &parent, int r)
+    {
+        while (parent[r] != r)
+        {
+            parent[r] = parent[parent[r]];
+            r = parent[r];
+        }
+        return r;
+    }
+
+    static void unite(std::vector<int> &parent, int a, int b)
+    {
+        a = find(parent, a);
+        b = find(parent, b);
+        if (a != b)
+        {
+            parent[std::max(a, b)] = std::min(a, b);
+        }
+    }
+
+    int newLabel()
+    {
+        count++;
+        if (!freeLabels.empty())
+        {
+            int l = freeLabels.back();
+            freeLabels.pop_back();
+            return l;
+        }
+        size.push_back(0);
+        return static_cast<int>(size.size()) - 1;
+    }
+
+    void freeLabel(int l)
+    {
+        count--;
+        size[l] = 0;
+        freeLabels.push_back(l);
+    }
+
+    // Breadth-first relabel of the walkable cells connected to from; returns how many.
+    int flood(int from, int l)
+    {
+        const CostLayer grid = costMap->getCostGrid();
+        queue.clear();
+        queue.push_back(from);
+        label[from] = l;
+        for (size_t head = 0; head < queue.size(); head++)
+        {
+            int idx = queue[head];
+            const int *delta = costMap->getNeighborDeltas(costMap->cellY(idx));
+            for (int i = 0; i < 6; i++)
+            {
+                int n = idx + delta[i];
+                if (grid[n] > 0 && label[n] != l)
+                {
+                    label[n] = l;
+                    queue.push_back(n);
+                }
+            }
+        }
+        return static_cast<int>(queue.size());
+    }
+
+    void addCell(int idx)
+    {
+        const int *delta = costMap->getNeighborDeltas(costMap->cellY(idx));
+        int best = NONE;
+        for (int i = 0; i < 6; i++)
+        {
+            int l = label[idx + delta[i]];
+            if (l != NONE && (best == NONE || size[l] > size[best]))
+            {
+                best = l;
+            }
+        }
+        if (best == NONE)
+        {
+            best = newLabel();
+        }
+        label[idx] = best;
+        size[best]++;
+        for (int i = 0; i < 6; i++)
+        {
+            int n = idx + delta[i];
+            int l = label[n];
+            if (l != NONE && l != best)
+            {
+                size[best] += flood(n, best); // stops at best's cells, so covers exactly l
+                freeLabel(l);
+            }
+        }
+    }
+
+    void removeCell(int idx)
+    {
+        const CostLayer grid = costMap->getCostGrid();
+        const int old = label[idx];
+        label[idx] = NONE;
+        if (old == NONE)
+        {
+            return;
+        }
+        if (--size[old] == 0)
+        {
+            freeLabel(old);
+            return;
+        }
+
+        // neighbours come in ring order, adjacent ones touch each other
+        const int *delta = costMap->getNeighborDeltas(costMap->cellY(idx));
+        int runs = 0;
+        for (int i = 0; i < 6; i++)
+        {
+            if (grid[idx + delta[i]] > 0 && grid[idx + delta[(i + 5) % 6]] <= 0)
+            {
+                runs++;
+            }
+        }
+        if (runs <= 1)
+        {
+            return;
+        }
+
+        // Possibly split: flood from the first cell of each run not reached yet.
+        for (int i = 0; i < 6; i++)
+        {
+            int n = idx + delta[i];
+            if (grid[n] > 0 && grid[idx + delta[(i + 5) % 6]] <= 0 && label[n] == old)
+            {
+                int l = newLabel();
+                size[l] = flood(n, l);
+            }
+        }
+        freeLabel(old);
+    }
+};
@@ -0,0 +1,293 @@
+#pragma once
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <type_traits>
+#include <algorithm>
+#include "CostMap.h"
+#include "MappedFile.h"
+
+// Binary CostMap file, little-endian, sections 64-byte aligned:
+//   header | cost cells | walkable mask | chunk index (optional)
+// Cost cells and mask are byte for byte what CostMap keeps in memory (padded
+// cells, see CostMap::index(), then the row-aligned mask words), so open()
+// validates the header, checks cells and mask in one pass (padding ring, mask
+// bits, maxCost) and CostMap wraps the mapping directly.
+struct CostMapFileHeader
+{
+    char magic[4];      // "HXCM"
+    uint32_t version;
+    uint32_t headerSize; // sizeof(CostMapFileHeader)
+    uint32_t byteOrder;  // ENDIAN_MARK as written
+    int32_t width, height;
+    int32_t maxCost;
+    int32_t chunkSize;   // cells per chunk side, 0: no chunk index
+    uint64_t costOffset, costBytes;
+    uint64_t maskOffset, maskBytes;
+    uint64_t chunkOffset; // CostMapChunkSummary[chunksX * chunksY], row-major
+    int32_t chunksX, chunksY;
+    uint64_t checksum;    // FNV-1a of the cost cells, 0: none
+};
+
+// What a loader can learn about a chunk without touching its cells.
+struct CostMapChunkSummary
+{
+    uint32_t walkable; // walkable cells
+    uint16_t maxCost;
+    uint16_t reserved;
+};
+
+static_assert(std::is_trivially_copyable<CostMapFileHeader>::value, "header is written as raw bytes");
+
+class CostMapFile
+{
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr uint32_t ENDIAN_MARK = 0x01020304;
+    static constexpr size_t ALIGN = 64;
+
+    static uint64_t checksum(const uint8_t *data, size_t n)
+    {
+        uint64_t h = 0xcbf29ce484222325ull;
+        for (size_t i = 0; i < n; i++)
+        {
+            h = (h ^ data[i]) * 0x100000001b3ull;
+        }
+        return h == 0 ? 1 : h; // 0 means "no checksum"
+    }
+
+    // Writes to path + ".tmp", then renames over path, so a map still mapped
+    // from path keeps its old contents. chunkSize 0 leaves out the chunk index.
+    static bool save(const CostMap &map, const std::string &path, int chunkSize = 64, bool withChecksum = true)
+    {
+        const int w = map.getWidth();
+        const int h = map.getHeight();
+        CostMapFileHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, "HXCM", 4);
+        header.version = VERSION;
+        header.headerSize = sizeof(CostMapFileHeader);
+        header.byteOrder = ENDIAN_MARK;
+        header.width = w;
+        header.height = h;
+        header.maxCost = map.maxCost;
+        header.costOffset = align(sizeof(CostMapFileHeader));
+        header.costBytes = map.getCostGrid().size();
+        header.maskOffset = align(header.costOffset + header.costBytes);
+        header.maskBytes = static_cast<uint64_t>(map.getMaskStride()) * h * sizeof(uint64_t);
+
+        std::vector<CostMapChunkSummary> chunks;
+        if (chunkSize > 0)
+        {
+            header.chunkSize = chunkSize;
+            header.chunksX = (w + chunkSize - 1) / chunkSize;
+            header.chunksY = (h + chunkSize - 1) / chunkSize;
+            header.chunkOffset = align(header.maskOffset + header.maskBytes);
+            chunks = summarize(map, chunkSize, header.chunksX, header.chunksY);
+        }
+        const uint8_t *cells = map.getCostGrid().data();
+        if (withChecksum)
+        {
+            header.checksum = checksum(cells, header.costBytes);
+        }
+
+        const std::string tmp = path + ".tmp";
+        {
+            std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+            if (!out)
+            {
+                return false;
+            }
+            out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            pad(out, header.costOffset);
+            out.write(reinterpret_cast<const char *>(cells), header.costBytes);
+            pad(out, header.maskOffset);
+            out.write(reinterpret_cast<const char *>(map.getWalkableRow(0)), header.maskBytes);
+            if (!chunks.empty())
+            {
+                pad(out, header.chunkOffset);
+                out.write(reinterpret_cast<const char *>(chunks.data()), chunks.size() * sizeof(CostMapChunkSummary));
+            }
+            if (!out.flush())
+            {
+                return false;
+            }
+        }
+        std::remove(path.c_str());
+        return std::rename(tmp.c_str(), path.c_str()) == 0;
+    }
+
+    // Maps a file for CostMap(const MappedCostLayer &). verify also checks the
+    // checksum, a second pass over the cells.
+    static bool open(const std::string &path, MappedCostLayer &layer, bool verify = false)
+    {
+        std::shared_ptr<MappedFile> file = MappedFile::open(path);
+        const CostMapFileHeader *header = file ? getHeader(*file) : nullptr;
+        if (!header)
+        {
+            return false;
+        }
+        if (verify && header->checksum != 0 &&
+            checksum(file->data() + header->costOffset, header->costBytes) != header->checksum)
+        {
+            return false;
+        }
+        layer.file = file;
+        layer.costOffset = header->costOffset;
+        layer.maskOffset = header->maskOffset;
+        layer.width = header->width;
+        layer.height = header->height;
+        layer.maxCost = header->maxCost;
+        return true;
+    }
+
+    // Validated header of a mapped map file, null if it is not one.
+    static const CostMapFileHeader *getHeader(const MappedFile &file)
+    {
+        if (file.size() < sizeof(CostMapFileHeader))
+        {
+            return nullptr;
+        }
+        const CostMapFileHeader *header = reinterpret_cast<const CostMapFileHeader *>(file.data());
+        if (std::memcmp(header->magic, "HXCM", 4) != 0 || header->version != VERSION ||
+            header->headerSize != sizeof(CostMapFileHeader) || header->byteOrder != ENDIAN_MARK)
+        {
+            return nullptr;
+        }
+        const int w = header->width;
+        const int h = header->height;
+        if (w <= 0 || h <= 0 || header->maxCost < CostMap::DEFAULT_COST || header->maxCost > CostMap::MAX_COST)
+        {
+            return nullptr;
+        }
+        if (header->costBytes != static_cast<uint64_t>(w + 2) * (h + 2) ||
+            header->maskBytes != static_cast<uint64_t>((w + 63) / 64) * h * sizeof(uint64_t) ||
+            header->maskOffset % sizeof(uint64_t) != 0 ||
+            !fits(file, header->costOffset, header->costBytes) || !fits(file, header->maskOffset, header->maskBytes))
+        {
+            return nullptr;
+        }
+        if (header->chunkSize > 0 &&
+            (header->chunksX != (w + header->chunkSize - 1) / header->chunkSize ||
+             header->chunksY != (h + header->chunkSize - 1) / header->chunkSize ||
+             !fits(file, header->chunkOffset,
+                   static_cast<uint64_t>(header->chunksX) * header->chunksY * sizeof(CostMapChunkSummary))))
+        {
+            return nullptr;
+        }
+        const uint8_t *cells = file.data() + header->costOffset;
+        if (!paddingIsObstacle(cells, w, h))
+        {
+            return nullptr; // searches rely on the ring to stop at the map edge
+        }
+        if (!cellsMatch(cells, reinterpret_cast<const uint64_t *>(file.data() + header->maskOffset), w, h,
+                        header->maxCost))
+        {
+            return nullptr; // walkable runs come from the mask, open list sizes from maxCost
+        }
+        return header;
+    }
+
+    // Chunk index of a file accepted by getHeader(), null if it has none.
+    static const CostMapChunkSummary *getChunks(const MappedFile &file)
+    {
+        const CostMapFileHeader *header = reinterpret_cast<const CostMapFileHeader *>(file.data());
+        if (header->chunkSize <= 0)
+        {
+            return nullptr;
+        }
+        return reinterpret_cast<const CostMapChunkSummary *>(file.data() + header->chunkOffset);
+    }
+
+private:
+    static uint64_t align(uint64_t offset)
+    {
+        return (offset + ALIGN - 1) / ALIGN * ALIGN;
+    }
+
+    static bool fits(const MappedFile &file, uint64_t offset, uint64_t bytes)
+    {
+        return offset <= file.size() && bytes <= file.size() - offset;
+    }
+
+    // The ring of padding cells around the map, O(width + height).
+    static bool paddingIsObstacle(const uint8_t *cells, int w, int h)
+    {
+        const size_t stride = static_cast<size_t>(w) + 2;
+        const uint8_t *top = cells;
+        const uint8_t *bottom = cells + (static_cast<size_t>(h) + 1) * stride;
+        for (size_t x = 0; x < stride; x++)
+        {
+            if (top[x] != CostMap::OBSTACLE || bottom[x] != CostMap::OBSTACLE)
+                return false;
+        }
+        for (int y = 1; y <= h; y++)
+        {
+            const uint8_t *row = cells + static_cast<size_t>(y) * stride;
+            if (row[0] != CostMap::OBSTACLE || row[stride - 1] != CostMap::OBSTACLE)
+                return false;
+        }
+        return true;
+    }
+
+    // Every mask bit set exactly for the walkable cells, none past the row's
+    // width, and no cell above maxCost.
+    static bool cellsMatch(const uint8_t *cells, const uint64_t *mask, int w, int h, int maxCost)
+    {
+        const size_t stride = static_cast<size_t>(w) + 2;
+        const int maskStride = (w + 63) / 64;
+        for (int y = 0; y < h; y++)
+        {
+            const uint8_t *row = cells + (static_cast<size_t>(y) + 1) * stride + 1;
+            for (int word = 0; word < maskStride; word++)
+            {
+                uint64_t expected = 0;
+                const int x0 = word * 64;
+                const int n = std::min(64, w - x0);
+                for (int i = 0; i < n; i++)
+                {
+                    if (row[x0 + i] > maxCost)
+                        return false;
+                    expected |= uint64_t(row[x0 + i] != CostMap::OBSTACLE) << i;
+                }
+                if (mask[static_cast<size_t>(y) * maskStride + word] != expected)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    static void pad(std::ofstream &out, uint64_t offset)
+    {
+        static const char zeros[ALIGN] = {};
+        out.write(zeros, static_cast<std::streamsize>(offset - static_cast<uint64_t>(out.tellp())));
+    }
+
+    static std::vector<CostMapChunkSummary> summarize(const CostMap &map, int chunkSize, int chunksX, int chunksY)
+    {
+        std::vector<CostMapChunkSummary> chunks(static_cast<size_t>(chunksX) * chunksY);
+        const CostLayer cells = map.getCostGrid();
+        for (int cy = 0; cy < chunksY; cy++)
+        {
+            for (int cx = 0; cx < chunksX; cx++)
+            {
+                const int x0 = cx * chunkSize, y0 = cy * chunkSize;
+                const int x1 = std::min(x0 + chunkSize, map.getWidth()) - 1;
+                const int y1 = std::min(y0 + chunkSize, map.getHeight()) - 1;
+                CostMapChunkSummary &chunk = chunks[static_cast<size_t>(cy) * chunksX + cx];
+                chunk.walkable = static_cast<uint32_t>(map.countWalkable(x0, y0, x1, y1));
+                chunk.maxCost = 0;
+                chunk.reserved = 0;
+                for (int y = y0; y <= y1; y++)
+                {
+                    const uint8_t *row = &cells[map.index(x0, y)];
+                    chunk.maxCost = std::max<uint16_t>(chunk.maxCost, *std::max_element(row, row + (x1 - x0 + 1)));
+                }
+            }
+        }
+        return chunks;
+    }
+};
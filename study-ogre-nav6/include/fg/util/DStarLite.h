@@ -0,0 +1,250 @@
+#pragma once
+#include <vector>
+#include <set>
+#include <tuple>
+#include <climits>
+#include <cstdint>
+#include "CostMap.h"
+
+// Incremental planner for one moving unit (D* Lite, Koenig & Likhachev).
+// Searches backwards from the goal and keeps g/rhs values between calls, so
+// after setCost() only the part of the search affected by the changed cells is
+// repaired. Handles cost increases (also to OBSTACLE) and decreases.
+// Moving into a cell costs that cell's cost, the same model as CostMap::findPath.
+//
+// Typical use: construct, replan(), follow getPath(); when the unit enters a new
+// cell call moveStart(), and call replan() again whenever the map changed.
+class DStarLitePlanner : public CostMap::Listener
+{
+    static constexpr int INF = INT_MAX / 4;
+    using Key = std::pair<int, int>;
+
+    CostMap *costMap;
+    int start, goal, last; // cell indices; last: start when km was last updated
+    int km = 0;
+    std::vector<int> g;
+    std::vector<int> rhs;
+    std::vector<Key> queuedKey;
+    std::vector<uint8_t> queued;
+    std::set<std::tuple<int, int, int>> open; // (k1, k2, cell)
+    std::vector<int> changed;                 // cells changed since the last replan()
+    size_t expanded = 0;
+
+public:
+    DStarLitePlanner(CostMap *costMap, CellKey startCell, CellKey goalCell) : costMap(costMap)
+    {
+        const size_t cells = costMap->getCostGrid().size();
+        g.assign(cells, INF);
+        rhs.assign(cells, INF);
+        queuedKey.assign(cells, Key(0, 0));
+        queued.assign(cells, 0);
+        start = last = costMap->index(startCell.first, startCell.second);
+        goal = costMap->index(goalCell.first, goalCell.second);
+        if (walkable(goal))
+        {
+            rhs[goal] = 0;
+            insert(goal, calculateKey(goal));
+        }
+        costMap->addListener(this);
+    }
+
+    ~DStarLitePlanner()
+    {
+        costMap->removeListener(this);
+    }
+
+    void costChanged(int x, int y, int /*oldCost*/, int /*newCost*/) override
+    {
+        changed.push_back(costMap->index(x, y));
+    }
+
+    // The unit now stands on this cell.
+    void moveStart(CellKey cell)
+    {
+        start = costMap->index(cell.first, cell.second);
+    }
+
+    // Nodes expanded by the last replan().
+    size_t getLastExpanded() const
+    {
+        return expanded;
+    }
+
+    // Repair the search after map changes / start moves; false if the goal is unreachable.
+    bool replan()
+    {
+        expanded = 0;
+        if (!changed.empty())
+        {
+            km += heuristic(last, start);
+            last = start;
+            for (int v : changed)
+            {
+                // edges into v changed cost; edges out of v only if its walkability did
+                updateVertex(v);
+                const int *delta = costMap->getNeighborDeltas(costMap->cellY(v));
+                for (int i = 0; i < 6; i++)
+                {
+                    updateVertex(v + delta[i]);
+                }
+            }
+            changed.clear();
+        }
+        computeShortestPath();
+        return walkable(start) && g[start] < INF;
+    }
+
+    // Cost of the current path from the start, -1 if unreachable.
+    int getPathCost() const
+    {
+        return g[start] < INF ? g[start] : -1;
+    }
+
+    // Current cheapest path from start to goal, same form as CostMap::findPath.
+    std::vector<Ogre::Vector2> getPath() const
+    {
+        std::vector<Ogre::Vector2> path;
+        if (!walkable(start) || g[start] >= INF)
+        {
+            return path;
+        }
+        const CostLayer grid = costMap->getCostGrid();
+        int s = start;
+        path.push_back(toVector(s));
+        for (size_t steps = 0; s != goal && steps < grid.size(); steps++)
+        {
+            const int *delta = costMap->getNeighborDeltas(costMap->cellY(s));
+            int best = -1;
+            int bestCost = INF;
+            for (int i = 0; i < 6; i++)
+            {
+                int n = s + delta[i];
+                if (!walkable(n) || g[n] >= INF)
+                    continue;
+                int c = grid[n] + g[n];
+                if (c < bestCost)
+                {
+                    bestCost = c;
+                    best = n;
+                }
+            }
+            if (best < 0)
+            {
+                path.clear();
+                return path;
+            }
+            s = best;
+            path.push_back(toVector(s));
+        }
+        return path;
+    }
+
+private:
+    bool walkable(int idx) const
+    {
+        return costMap->getCostGrid()[idx] > 0;
+    }
+
+    Ogre::Vector2 toVector(int idx) const
+    {
+        return Ogre::Vector2(static_cast<float>(costMap->cellX(idx)), static_cast<float>(costMap->cellY(idx)));
+    }
+
+    int heuristic(int a, int b) const
+    {
+        return CostMap::hexDistance(costMap->cellX(a), costMap->cellY(a), costMap->cellX(b), costMap->cellY(b)) * CostMap::DEFAULT_COST;
+    }
+
+    Key calculateKey(int s) const
+    {
+        int m = std::min(g[s], rhs[s]);
+        return Key(m >= INF ? INF : m + heuristic(start, s) + km, m);
+    }
+
+    void insert(int s, Key k)
+    {
+        open.insert(std::make_tuple(k.first, k.second, s));
+        queuedKey[s] = k;
+        queued[s] = 1;
+    }
+
+    void remove(int s)
+    {
+        if (queued[s])
+        {
+            open.erase(std::make_tuple(queuedKey[s].first, queuedKey[s].second, s));
+            queued[s] = 0;
+        }
+    }
+
+    void updateVertex(int u)
+    {
+        if (u != goal)
+        {
+            int best = INF;
+            if (walkable(u))
+            {
+                const CostLayer grid = costMap->getCostGrid();
+                const int *delta = costMap->getNeighborDeltas(costMap->cellY(u));
+                for (int i = 0; i < 6; i++)
+                {
+                    int n = u + delta[i];
+                    if (walkable(n) && g[n] < INF)
+                    {
+                        best = std::min(best, grid[n] + g[n]);
+                    }
+                }
+            }
+            rhs[u] = best;
+        }
+        remove(u);
+        if (g[u] != rhs[u])
+        {
+            insert(u, calculateKey(u));
+        }
+    }
+
+    void computeShortestPath()
+    {
+        while (!open.empty())
+        {
+            auto top = *open.begin();
+            Key kOld(std::get<0>(top), std::get<1>(top));
+            Key kStart = calculateKey(start);
+            if (!(kOld < kStart) && rhs[start] == g[start])
+            {
+                break;
+            }
+            int u = std::get<2>(top);
+            Key kNew = calculateKey(u);
+            expanded++;
+            if (kOld < kNew)
+            {
+                remove(u);
+                insert(u, kNew);
+            }
+            else if (g[u] > rhs[u])
+            {
+                g[u] = rhs[u];
+                remove(u);
+                updatePredecessors(u);
+            }
+            else
+            {
+                g[u] = INF;
+                updateVertex(u);
+                updatePredecessors(u);
+            }
+        }
+    }
+
+    // Every neighbour can step into u, so all of them are predecessors.
+    void updatePredecessors(int u)
+    {
+        const int *delta = costMap->getNeighborDeltas(costMap->cellY(u));
+        for (int i = 0; i < 6; i++)
+        {
+            updateVertex(u + delta[i]);
+        }
+    }
+};
@@ -0,0 +1,179 @@
+#pragma once
+#include <vector>
+#include <list>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
+#include "CostMap.h"
+
+// Per-cell direction towards one goal, built by a single reverse Dijkstra pass.
+// Following dir from any reachable cell walks a cheapest path to the goal, so
+// many actors sharing a destination need one search instead of one each.
+// Arrays are indexed like CostMap::costGrid.
+class FlowField
+{
+    int width, height, stride;
+    int goal;                 // cell index
+    std::vector<int> cost;    // cost to reach the goal, -1: unreachable
+    std::vector<int8_t> dir;  // getNeighbor() direction of the next step, -1: none
+
+public:
+    FlowField(const CostMap &costMap, int goalX, int goalY)
+        : width(costMap.getWidth()), height(costMap.getHeight()), stride(costMap.getStride())
+    {
+        const CostLayer grid = costMap.getCostGrid();
+        goal = costMap.index(goalX, goalY);
+        cost.assign(grid.size(), -1);
+        dir.assign(grid.size(), -1);
+        if (!costMap.isWalkable(goalX, goalY))
+        {
+            return;
+        }
+
+        // stepping from u into v costs grid[v], so every neighbour of v is offered cost[v] + grid[v]
+        BucketOpenList open;
+        open.reset(grid.size(), costMap.maxCost);
+        std::vector<uint8_t> closed(grid.size(), 0);
+        cost[goal] = 0;
+        open.push({goalX, goalY, 0, 0, goal});
+        while (!open.empty())
+        {
+            NavNode v = open.pop();
+            if (closed[v.idx])
+                continue; // left behind by decrease()
+            closed[v.idx] = 1;
+            const int step = v.g + grid[v.idx];
+            const int *delta = costMap.getNeighborDeltas(v.y);
+            for (int i = 0; i < 6; i++)
+            {
+                const int u = v.idx + delta[i];
+                if (grid[u] <= 0 || closed[u])
+                    continue;
+                if (cost[u] < 0 || step < cost[u])
+                {
+                    int oldCost = cost[u];
+                    cost[u] = step;
+                    dir[u] = static_cast<int8_t>((i + 3) % 6); // opposite direction leads back to v
+                    auto [ux, uy] = costMap.getNeighbor(v.x, v.y, i);
+                    if (oldCost < 0)
+                        open.push({ux, uy, step, 0, u});
+                    else
+                        open.decrease({ux, uy, step, 0, u}, oldCost);
+                }
+            }
+        }
+    }
+
+    int getGoal() const
+    {
+        return goal;
+    }
+
+    bool isInside(int x, int y) const
+    {
+        return x >= 0 && x < width && y >= 0 && y < height;
+    }
+
+    // Cost of the cheapest path from (x, y) to the goal, -1 if unreachable.
+    int getCostToGoal(int x, int y) const
+    {
+        return isInside(x, y) ? cost[(y + 1) * stride + (x + 1)] : -1;
+    }
+
+    // Direction (as in CostMap::getNeighbor) of the next step, -1 at the goal or if unreachable.
+    int getDirection(int x, int y) const
+    {
+        return isInside(x, y) ? dir[(y + 1) * stride + (x + 1)] : -1;
+    }
+
+    // Next cell on the way to the goal; false at the goal or if unreachable.
+    bool nextCell(const CostMap &costMap, int x, int y, int &nx, int &ny) const
+    {
+        int d = getDirection(x, y);
+        if (d < 0)
+        {
+            return false;
+        }
+        auto next = costMap.getNeighbor(x, y, d);
+        nx = next.first;
+        ny = next.second;
+        return true;
+    }
+
+    // Whole path from (x, y) to the goal.
+    CellPath extractPath(int x, int y) const
+    {
+        CellPath path;
+        if (getCostToGoal(x, y) < 0)
+        {
+            return path;
+        }
+        path.start(x, y);
+        for (int d = getDirection(x, y); d >= 0; d = getDirection(x, y))
+        {
+            path.push(d);
+            CellPath::step(x, y, d);
+        }
+        return path;
+    }
+};
+
+// Flow fields by goal cell, least recently used dropped beyond capacity.
+// Any setCost() invalidates every field, since a field depends on the whole map;
+// followers still holding a field keep their (stale) copy alive.
+class FlowFieldCache : public CostMap::Listener
+{
+    using Entry = std::pair<int, std::shared_ptr<const FlowField>>;
+
+    CostMap *costMap;
+    size_t capacity;
+    std::list<Entry> lru; // most recent first
+    std::unordered_map<int, std::list<Entry>::iterator> fields;
+
+public:
+    FlowFieldCache(CostMap *costMap, size_t capacity = 8) : costMap(costMap), capacity(capacity)
+    {
+        costMap->addListener(this);
+    }
+
+    ~FlowFieldCache()
+    {
+        costMap->removeListener(this);
+    }
+
+    bool contains(CellKey goal) const
+    {
+        return fields.find(costMap->index(goal.first, goal.second)) != fields.end();
+    }
+
+    std::shared_ptr<const FlowField> get(CellKey goal)
+    {
+        int key = costMap->index(goal.first, goal.second);
+        auto it = fields.find(key);
+        if (it != fields.end())
+        {
+            lru.splice(lru.begin(), lru, it->second);
+            return it->second->second;
+        }
+        auto field = std::make_shared<const FlowField>(*costMap, goal.first, goal.second);
+        lru.push_front({key, field});
+        fields[key] = lru.begin();
+        if (lru.size() > capacity)
+        {
+            fields.erase(lru.back().first);
+            lru.pop_back();
+        }
+        return field;
+    }
+
+    void clear()
+    {
+        lru.clear();
+        fields.clear();
+    }
+
+    void costChanged(int /*x*/, int /*y*/, int /*oldCost*/, int /*newCost*/) override
+    {
+        clear();
+    }
+};
@@ -0,0 +1,88 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <climits>
+#include <utility>
+#include <algorithm>
+#include "HexCoord.h"
+
+// Goal cells grouped into square buckets, for the "distance to the nearest
+// goal" heuristic of multi-goal searches. A hex step moves at most one column
+// and one row, so the bounding box of a bucket's goals gives a lower bound for
+// all of them at once and most buckets are skipped without looking inside.
+class GoalBuckets
+{
+    struct Bucket
+    {
+        int x0, y0, x1, y1; // bounding box of its goals
+        size_t begin, end;  // range in goals
+    };
+
+    std::vector<Bucket> buckets;
+    std::vector<std::pair<int, int>> goals; // grouped by bucket
+
+public:
+    void assign(const std::vector<std::pair<int, int>> &cells, int bucketSize = 16)
+    {
+        buckets.clear();
+        goals = cells;
+        auto bucketOf = [bucketSize](const std::pair<int, int> &c)
+        {
+            return (static_cast<int64_t>(c.second / bucketSize) << 32) | static_cast<uint32_t>(c.first / bucketSize);
+        };
+        std::sort(goals.begin(), goals.end(), [&bucketOf](const std::pair<int, int> &a, const std::pair<int, int> &b)
+                  { return bucketOf(a) < bucketOf(b); });
+        for (size_t i = 0; i < goals.size(); i++)
+        {
+            const auto &g = goals[i];
+            if (i == 0 || bucketOf(g) != bucketOf(goals[i - 1]))
+            {
+                buckets.push_back({g.first, g.second, g.first, g.second, i, i});
+            }
+            Bucket &b = buckets.back();
+            b.x0 = std::min(b.x0, g.first);
+            b.x1 = std::max(b.x1, g.first);
+            b.y0 = std::min(b.y0, g.second);
+            b.y1 = std::max(b.y1, g.second);
+            b.end = i + 1;
+        }
+    }
+
+    bool empty() const
+    {
+        return goals.empty();
+    }
+
+    const std::vector<std::pair<int, int>> &getGoals() const
+    {
+        return goals;
+    }
+
+    // Hex distance from (x, y) to the nearest goal, INT_MAX without goals.
+    // goal, if given, receives that goal's position in getGoals().
+    int nearest(int x, int y, size_t *goal = nullptr) const
+    {
+        int best = INT_MAX;
+        const HexAxial from = Hex::toAxial(x, y);
+        for (const Bucket &b : buckets)
+        {
+            const int dx = std::max({b.x0 - x, x - b.x1, 0});
+            const int dy = std::max({b.y0 - y, y - b.y1, 0});
+            if (std::max(dx, dy) >= best)
+                continue;
+            for (size_t i = b.begin; i < b.end; i++)
+            {
+                const int d = Hex::distance(from, Hex::toAxial(goals[i].first, goals[i].second));
+                if (d < best)
+                {
+                    best = d;
+                    if (goal)
+                    {
+                        *goal = i;
+                    }
+                }
+            }
+        }
+        return best;
+    }
+};
@@ -0,0 +1,120 @@
+#pragma once
+#include <cstddef>
+#include <algorithm>
+#include "PathSearchContext.h"
+#include "HexCoord.h"
+
+// Neighbourhoods for GridSearch: constexpr offset tables by row parity, so
+// the neighbour loop has a fixed trip count and unrolls.
+struct HexTopology
+{
+    static constexpr int DEGREE = 6;
+    static constexpr int PARITIES = 2;
+
+    static constexpr int parity(int y) { return y & 1; }
+    static constexpr int dx(int parity, int d) { return Hex::OFFSET_DX[parity][d]; }
+    static constexpr int dy(int, int d) { return Hex::OFFSET_DY[d]; }
+};
+
+// Square grid with diagonal moves; directions 0..7 run column by column.
+struct SquareTopology8
+{
+    static constexpr int DEGREE = 8;
+    static constexpr int PARITIES = 1;
+    static constexpr int DX[8] = {-1, -1, -1, 0, 0, 1, 1, 1};
+    static constexpr int DY[8] = {-1, 0, 1, -1, 1, -1, 0, 1};
+
+    static constexpr int parity(int) { return 0; }
+    static constexpr int dx(int, int d) { return DX[d]; }
+    static constexpr int dy(int, int d) { return DY[d]; }
+};
+
+// One A* for every padded row-major grid (index = (y + 1) * stride + x + 1,
+// border cells never enterable), specialised at compile time by policies:
+//   Topology   neighbour offsets, see HexTopology
+//   Cost       int cost(fromIdx, toIdx, direction), <= 0: cannot enter
+//   Heuristic  int heuristic(x, y, idx), consistent, never above the true cost
+// Cost and heuristic are usually lambdas, so each instantiation inlines into
+// a single loop. Integer costs keep PathSearchContext's bucket open list usable;
+// maxStep bounds the rise of f per step, i.e. the largest step cost plus the
+// largest change of the heuristic along it.
+class GridSearch
+{
+public:
+    template <typename Topology>
+    struct Deltas
+    {
+        int delta[Topology::PARITIES][Topology::DEGREE];
+
+        constexpr explicit Deltas(int stride) : delta{}
+        {
+            for (int p = 0; p < Topology::PARITIES; p++)
+            {
+                for (int d = 0; d < Topology::DEGREE; d++)
+                {
+                    delta[p][d] = Topology::dy(p, d) * stride + Topology::dx(p, d);
+                }
+            }
+        }
+    };
+
+    // On success ctx.chain holds the path's cell indices, start first; ctx.stats
+    // counts the search. Start and end are not checked for walkability here.
+    template <typename Topology, typename Cost, typename Heuristic>
+    static bool findPath(int stride, size_t cells, int startX, int startY, int endX, int endY, const Cost &cost,
+                         const Heuristic &heuristic, int maxStep, PathSearchContext &ctx)
+    {
+        const Deltas<Topology> deltas(stride);
+        ctx.chain.clear();
+        ctx.reset(cells, maxStep);
+        const int startIdx = (startY + 1) * stride + startX + 1;
+        const int endIdx = (endY + 1) * stride + endX + 1;
+        ctx.push({startX, startY, 0, heuristic(startX, startY, startIdx), startIdx});
+        ctx.visit(startIdx, 0, -1);
+
+        while (!ctx.open.empty())
+        {
+            NavNode current = ctx.pop();
+            const int currIdx = current.idx;
+            if (ctx.isClosed(currIdx))
+                continue;
+            ctx.close(currIdx);
+
+            if (currIdx == endIdx)
+            {
+                for (int idx = currIdx; idx != -1; idx = ctx.parent[idx])
+                {
+                    ctx.chain.push_back(idx);
+                }
+                std::reverse(ctx.chain.begin(), ctx.chain.end());
+                return true;
+            }
+
+            const int currG = ctx.gScore[currIdx];
+            const int p = Topology::parity(current.y);
+            for (int i = 0; i < Topology::DEGREE; i++)
+            {
+                const int nIdx = currIdx + deltas.delta[p][i];
+                const int moveCost = cost(currIdx, nIdx, i);
+                if (moveCost <= 0 || ctx.isClosed(nIdx))
+                    continue;
+
+                const int g = currG + moveCost;
+                const bool seen = ctx.isVisited(nIdx);
+                if (!seen || g < ctx.gScore[nIdx])
+                {
+                    const int oldG = ctx.gScore[nIdx];
+                    ctx.visit(nIdx, g, currIdx);
+                    const int nx = current.x + Topology::dx(p, i);
+                    const int ny = current.y + Topology::dy(p, i);
+                    const int h = heuristic(nx, ny, nIdx);
+                    if (seen)
+                        ctx.decrease({nx, ny, g, h, nIdx}, oldG + h);
+                    else
+                        ctx.push({nx, ny, g, h, nIdx});
+                }
+            }
+        }
+        return false;
+    }
+};
@@ -0,0 +1,239 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+
+// Axial hex coordinates (q, r); s = -q - r is implied.
+struct HexAxial
+{
+    int q, r;
+
+    constexpr bool operator==(const HexAxial &other) const { return q == other.q && r == other.r; }
+    constexpr bool operator!=(const HexAxial &other) const { return !(*this == other); }
+};
+
+struct HexCube
+{
+    int q, r, s;
+};
+
+// Coordinate maths for the grid's "odd-r" layout: cells are addressed by
+// offset (x, y), odd rows sit half a cell to the right. Offset neighbours
+// depend on row parity, axial ones do not, and distance is simplest in cube
+// coordinates, so everything converts through axial.
+// Directions 0..5 run E, upper right, upper left, W, lower left, lower right
+// (counter-clockwise on screen, y grows downwards); d and (d + 3) % 6 are opposite.
+class Hex
+{
+public:
+    static constexpr float SQRT3 = 1.7320508075688772f;
+
+    // Offset steps by row parity: OFFSET_DX[y & 1][d], OFFSET_DY[d].
+    static constexpr int OFFSET_DX[2][6] = {{+1, 0, -1, -1, -1, 0}, {+1, +1, 0, -1, 0, +1}};
+    static constexpr int OFFSET_DY[6] = {0, -1, -1, 0, +1, +1};
+    static constexpr int AXIAL_DQ[6] = {+1, +1, 0, -1, -1, 0};
+    static constexpr int AXIAL_DR[6] = {0, -1, -1, 0, +1, +1};
+
+    static constexpr bool isShifted(int y)
+    {
+        return (y & 1) != 0;
+    }
+
+    static constexpr HexAxial toAxial(int x, int y)
+    {
+        return {x - (y >> 1), y}; // y >> 1 == floor(y / 2), also for negative rows
+    }
+
+    static constexpr std::pair<int, int> toOffset(HexAxial a)
+    {
+        return {a.q + (a.r >> 1), a.r};
+    }
+
+    static constexpr HexCube toCube(HexAxial a)
+    {
+        return {a.q, a.r, -a.q - a.r};
+    }
+
+    static constexpr HexAxial toAxial(HexCube c)
+    {
+        return {c.q, c.r};
+    }
+
+    static constexpr int abs(int v)
+    {
+        return v < 0 ? -v : v;
+    }
+
+    static constexpr int distance(HexAxial a, HexAxial b)
+    {
+        // max(|dq|, |dr|, |ds|) == (|dq| + |dr| + |ds|) / 2 on a cube grid
+        return (abs(a.q - b.q) + abs(a.r - b.r) + abs(a.q + a.r - b.q - b.r)) / 2;
+    }
+
+    static constexpr int distance(int x1, int y1, int x2, int y2)
+    {
+        return distance(toAxial(x1, y1), toAxial(x2, y2));
+    }
+
+    static constexpr HexAxial neighbor(HexAxial a, int direction)
+    {
+        return {a.q + AXIAL_DQ[direction], a.r + AXIAL_DR[direction]};
+    }
+
+    static constexpr std::pair<int, int> neighbor(int x, int y, int direction)
+    {
+        return {x + OFFSET_DX[y & 1][direction], y + OFFSET_DY[direction]};
+    }
+
+    // Direction from a cell to an adjacent one, -1 if they are not adjacent.
+    static constexpr int directionTo(HexAxial from, HexAxial to)
+    {
+        for (int d = 0; d < 6; d++)
+        {
+            if (neighbor(from, d) == to)
+            {
+                return d;
+            }
+        }
+        return -1;
+    }
+
+    // Neighbour offsets as deltas of a row-major index with the given row stride,
+    // indexed [y & 1][direction].
+    static constexpr std::array<std::array<int, 6>, 2> linearDeltas(int stride)
+    {
+        std::array<std::array<int, 6>, 2> deltas{};
+        for (int parity = 0; parity < 2; parity++)
+        {
+            for (int d = 0; d < 6; d++)
+            {
+                deltas[parity][d] = OFFSET_DY[d] * stride + OFFSET_DX[parity][d];
+            }
+        }
+        return deltas;
+    }
+
+    // Calls f(x, y) for every cell at exactly `radius` steps, walking once around the ring.
+    template <typename F>
+    static void ring(int x, int y, int radius, F f)
+    {
+        if (radius == 0)
+        {
+            f(x, y);
+            return;
+        }
+        HexAxial a = toAxial(x, y);
+        a.q += AXIAL_DQ[4] * radius; // start lower left, then walk the six sides
+        a.r += AXIAL_DR[4] * radius;
+        for (int side = 0; side < 6; side++)
+        {
+            for (int i = 0; i < radius; i++)
+            {
+                auto [cx, cy] = toOffset(a);
+                f(cx, cy);
+                a = neighbor(a, side);
+            }
+        }
+    }
+
+    // Calls f(x, y) for every cell within `radius` steps, nearest rings first.
+    template <typename F>
+    static void spiral(int x, int y, int radius, F f)
+    {
+        for (int k = 0; k <= radius; k++)
+        {
+            ring(x, y, k, f);
+        }
+    }
+
+    static constexpr int cellsWithin(int radius)
+    {
+        return 3 * radius * (radius + 1) + 1;
+    }
+
+    // Calls f(x, y) for the cells under the straight line between two cell
+    // centres, from (x0, y0) to (x1, y1), each adjacent to the one before.
+    // Where the line runs along a cell edge, side (+1 / -1) picks which of
+    // the two cells is reported.
+    template <typename F>
+    static void line(int x0, int y0, int x1, int y1, F f, int side = 1)
+    {
+        const HexAxial a = toAxial(x0, y0);
+        const HexAxial b = toAxial(x1, y1);
+        const int n = distance(a, b);
+        const double e = 1e-6 * side;
+        for (int i = 0; i <= n; i++)
+        {
+            const double t = n == 0 ? 0.0 : static_cast<double>(i) / n;
+            const double q = a.q + e + (b.q - a.q) * t;
+            const double r = a.r + e + (b.r - a.r) * t;
+            auto [cx, cy] = toOffset(round(q, r));
+            f(cx, cy);
+        }
+    }
+
+    // Nearest cell to fractional axial coordinates.
+    static HexAxial round(double q, double r)
+    {
+        const double s = -q - r;
+        double rq = std::round(q), rr = std::round(r), rs = std::round(s);
+        const double dq = std::abs(rq - q), dr = std::abs(rr - r), ds = std::abs(rs - s);
+        if (dq > dr && dq > ds)
+        {
+            rq = -rr - rs;
+        }
+        else if (dr > ds)
+        {
+            rr = -rq - rs;
+        }
+        return {static_cast<int>(rq), static_cast<int>(rr)};
+    }
+
+    // Centre of a cell whose inner radius is rad (flat distance from centre to edge).
+    static constexpr std::pair<float, float> center(int x, int y, float rad)
+    {
+        return {x * 2 * rad + (isShifted(y) ? rad : 0.0f), y * rad * SQRT3};
+    }
+
+    // Batch versions over whole arrays. Branch-free, so compilers vectorise them.
+    static void toAxial(const int *x, const int *y, int *q, int *r, size_t n)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            q[i] = x[i] - (y[i] >> 1);
+            r[i] = y[i];
+        }
+    }
+
+    static void toOffset(const int *q, const int *r, int *x, int *y, size_t n)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            x[i] = q[i] + (r[i] >> 1);
+            y[i] = r[i];
+        }
+    }
+
+    // out[i] = distance from (x[i], y[i]) to (toX, toY).
+    static void distances(const int *x, const int *y, size_t n, int toX, int toY, int *out)
+    {
+        const HexAxial to = toAxial(toX, toY);
+        for (size_t i = 0; i < n; i++)
+        {
+            int dq = x[i] - (y[i] >> 1) - to.q;
+            int dr = y[i] - to.r;
+            int ds = dq + dr;
+            out[i] = (abs(dq) + abs(dr) + abs(ds)) / 2;
+        }
+    }
+
+    static void centers(const int *x, const int *y, size_t n, float rad, float *cx, float *cy)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            cx[i] = x[i] * 2 * rad + (y[i] & 1) * rad;
+            cy[i] = y[i] * rad * SQRT3;
+        }
+    }
+};
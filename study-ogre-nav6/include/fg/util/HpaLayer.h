@@ -0,0 +1,552 @@
+#pragma once
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <algorithm>
+#include <cstdint>
+#include "CostMap.h"
+
+// Hierarchical path finding (HPA*) over a CostMap.
+// The grid is split into clusterSize x clusterSize blocks of offset cells.
+// Each walkable run of cells along a shared cluster border becomes one entrance
+// (a cell pair, one on either side); the cost between entrances of the same
+// cluster is precomputed by a search restricted to that cluster.
+// findPath searches this abstract graph first and only then refines the chosen
+// hops cell by cell, inside one cluster at a time. Paths are near-optimal.
+//
+// The layer listens to setCost(): a changed cell marks its cluster dirty and
+// the next query rebuilds only dirty clusters (plus the neighbours sharing a
+// border when the cell lies on the cluster perimeter).
+// Not thread safe: queries rebuild lazily and share scratch buffers.
+class HpaLayer : public CostMap::Listener
+{
+    struct Cluster
+    {
+        int x0, y0, x1, y1;              // cell rect, [x0, x1) x [y0, y1)
+        std::vector<int> entrances;      // cell indices
+        std::vector<std::vector<int>> links; // per entrance, linked cells in other clusters
+        std::vector<int> dist;           // entrances x entrances, -1: unreachable
+        bool dirtyIntra = true;
+        bool dirtyBorder = true;
+    };
+
+    CostMap *costMap;
+    int clusterSize;
+    int clustersX, clustersY;
+    std::vector<Cluster> clusters;
+    // border transitions (cell in first cluster, cell in second), keyed by cluster ids (low, high)
+    std::unordered_map<std::pair<int, int>, std::vector<std::pair<int, int>>, PairHash> transitions;
+    std::vector<int> entranceSlot; // per cell: index in its cluster's entrances, -1 if none
+    bool dirty = true;
+
+    // abstract search state, indexed like costGrid
+    std::vector<int> aG;
+    std::vector<int> aParent;
+    std::vector<uint32_t> aSeen;
+    std::vector<uint32_t> aClosed;
+    std::vector<std::pair<int, int>> aHeap; // (f, cell index)
+    uint32_t aGen = 0;
+
+    // scratch of searchCluster(), indexed by cluster-local cell
+    std::vector<int> sDist;
+    std::vector<int> sParent;
+    std::vector<uint32_t> sSeen;
+    std::vector<uint32_t> sClosed;
+    std::vector<std::pair<int, int>> sHeap; // (f, cell index)
+    uint32_t sGen = 0;
+
+public:
+    HpaLayer(CostMap *costMap, int clusterSize = 16) : costMap(costMap), clusterSize(clusterSize)
+    {
+        clustersX = (costMap->getWidth() + clusterSize - 1) / clusterSize;
+        clustersY = (costMap->getHeight() + clusterSize - 1) / clusterSize;
+        clusters.resize(clustersX * clustersY);
+        for (int cy = 0; cy < clustersY; cy++)
+        {
+            for (int cx = 0; cx < clustersX; cx++)
+            {
+                Cluster &c = clusters[cy * clustersX + cx];
+                c.x0 = cx * clusterSize;
+                c.y0 = cy * clusterSize;
+                c.x1 = std::min(c.x0 + clusterSize, costMap->getWidth());
+                c.y1 = std::min(c.y0 + clusterSize, costMap->getHeight());
+            }
+        }
+        entranceSlot.assign(costMap->getCostGrid().size(), -1);
+        costMap->addListener(this);
+    }
+
+    ~HpaLayer()
+    {
+        costMap->removeListener(this);
+    }
+
+    int getClusterSize() const
+    {
+        return clusterSize;
+    }
+
+    int clusterOf(int x, int y) const
+    {
+        return (y / clusterSize) * clustersX + x / clusterSize;
+    }
+
+    void costChanged(int x, int y, int /*oldCost*/, int /*newCost*/) override
+    {
+        Cluster &c = clusters[clusterOf(x, y)];
+        c.dirtyIntra = true;
+        if (x == c.x0 || x == c.x1 - 1 || y == c.y0 || y == c.y1 - 1)
+        {
+            c.dirtyBorder = true;
+        }
+        dirty = true;
+    }
+
+    // Bring the abstract graph up to date with the cost map.
+    void update()
+    {
+        if (!dirty)
+        {
+            return;
+        }
+        std::vector<int> rebuild;
+        for (int id = 0; id < (int)clusters.size(); id++)
+        {
+            if (clusters[id].dirtyBorder)
+            {
+                forEachNeighborCluster(id, [this, id](int other)
+                                       { computeTransitions(id, other); });
+            }
+        }
+        for (int id = 0; id < (int)clusters.size(); id++)
+        {
+            if (clusters[id].dirtyBorder)
+            {
+                rebuild.push_back(id);
+                forEachNeighborCluster(id, [&rebuild](int other)
+                                       { rebuild.push_back(other); });
+            }
+            else if (clusters[id].dirtyIntra)
+            {
+                rebuild.push_back(id);
+            }
+        }
+        std::sort(rebuild.begin(), rebuild.end());
+        rebuild.erase(std::unique(rebuild.begin(), rebuild.end()), rebuild.end());
+        for (int id : rebuild)
+        {
+            buildEntrances(id);
+        }
+        for (int id : rebuild)
+        {
+            buildIntraCosts(id);
+            clusters[id].dirtyIntra = false;
+            clusters[id].dirtyBorder = false;
+        }
+        dirty = false;
+    }
+
+    std::vector<Ogre::Vector2> findPath(CellKey start, CellKey end)
+    {
+        return findPath(start.first, start.second, end.first, end.second);
+    }
+
+    std::vector<Ogre::Vector2> findPath(int startX, int startY, int endX, int endY)
+    {
+        std::vector<int> cells;
+        if (findCells(startX, startY, endX, endY, cells))
+        {
+            std::vector<Ogre::Vector2> path(cells.size());
+            for (size_t i = 0; i < cells.size(); i++)
+            {
+                path[i] = Ogre::Vector2(static_cast<float>(costMap->cellX(cells[i])), static_cast<float>(costMap->cellY(cells[i])));
+            }
+            return path;
+        }
+        return {};
+    }
+
+    // Path as costGrid indices, start and end included.
+    bool findCells(int startX, int startY, int endX, int endY, std::vector<int> &cells)
+    {
+        cells.clear();
+        if (!costMap->isWalkable(startX, startY) || !costMap->isWalkable(endX, endY))
+        {
+            return false;
+        }
+        update();
+
+        const int s = costMap->index(startX, startY);
+        const int e = costMap->index(endX, endY);
+        const int cs = clusterOf(startX, startY);
+        const int ce = clusterOf(endX, endY);
+
+        if (cs == ce && searchCluster(clusters[cs], s, e, false))
+        {
+            appendScratchPath(e, cells);
+            return true;
+        }
+
+        // edges from start into its cluster's entrances, and from the goal cluster's entrances to the goal
+        const Cluster &startCluster = clusters[cs];
+        const Cluster &endCluster = clusters[ce];
+        std::vector<int> startDist(startCluster.entrances.size(), -1);
+        std::vector<int> endDist(endCluster.entrances.size(), -1);
+        searchCluster(startCluster, s, -1, false);
+        for (size_t i = 0; i < startCluster.entrances.size(); i++)
+        {
+            startDist[i] = scratchDistance(startCluster, startCluster.entrances[i]);
+        }
+        searchCluster(endCluster, e, -1, true);
+        for (size_t i = 0; i < endCluster.entrances.size(); i++)
+        {
+            endDist[i] = scratchDistance(endCluster, endCluster.entrances[i]);
+        }
+
+        // A* over the abstract graph, nodes are cell indices
+        const size_t cellCount = costMap->getCostGrid().size();
+        if (aSeen.size() != cellCount)
+        {
+            aG.resize(cellCount);
+            aParent.resize(cellCount);
+            aSeen.assign(cellCount, 0);
+            aClosed.assign(cellCount, 0);
+            aGen = 0;
+        }
+        if (++aGen == 0)
+        {
+            std::fill(aSeen.begin(), aSeen.end(), 0);
+            std::fill(aClosed.begin(), aClosed.end(), 0);
+            aGen = 1;
+        }
+        aHeap.clear();
+        auto cmp = std::greater<std::pair<int, int>>();
+
+        auto h = [this, endX, endY](int idx)
+        {
+            return CostMap::hexDistance(costMap->cellX(idx), costMap->cellY(idx), endX, endY) * CostMap::DEFAULT_COST;
+        };
+        auto relax = [&](int from, int to, int cost)
+        {
+            int ng = aG[from] + cost;
+            if (aClosed[to] != aGen && (aSeen[to] != aGen || ng < aG[to]))
+            {
+                aSeen[to] = aGen;
+                aG[to] = ng;
+                aParent[to] = from;
+                aHeap.push_back({ng + h(to), to});
+                std::push_heap(aHeap.begin(), aHeap.end(), cmp);
+            }
+        };
+
+        aSeen[s] = aGen;
+        aG[s] = 0;
+        aHeap.push_back({h(s), s});
+        bool found = false;
+        while (!aHeap.empty())
+        {
+            std::pop_heap(aHeap.begin(), aHeap.end(), cmp);
+            int node = aHeap.back().second;
+            aHeap.pop_back();
+            if (aClosed[node] == aGen)
+                continue;
+            aClosed[node] = aGen;
+            if (node == e)
+            {
+                found = true;
+                break;
+            }
+
+            if (node == s)
+            {
+                for (size_t i = 0; i < startDist.size(); i++)
+                {
+                    if (startDist[i] >= 0)
+                        relax(s, startCluster.entrances[i], startDist[i]);
+                }
+            }
+            const int i = entranceSlot[node];
+            if (i < 0)
+                continue;
+
+            const int cid = clusterOf(costMap->cellX(node), costMap->cellY(node));
+            const Cluster &c = clusters[cid];
+            const int n = (int)c.entrances.size();
+            for (int j = 0; j < n; j++)
+            {
+                int d = c.dist[i * n + j];
+                if (j != i && d >= 0)
+                    relax(node, c.entrances[j], d);
+            }
+            for (int other : c.links[i])
+            {
+                relax(node, other, costMap->getCostGrid()[other]);
+            }
+            if (cid == ce && endDist[i] >= 0)
+            {
+                relax(node, e, endDist[i]);
+            }
+        }
+        if (!found)
+        {
+            return false;
+        }
+
+        std::vector<int> hops;
+        for (int node = e;; node = aParent[node])
+        {
+            hops.push_back(node);
+            if (node == s)
+                break;
+        }
+        std::reverse(hops.begin(), hops.end());
+
+        // refine every hop into cells
+        cells.push_back(s);
+        for (size_t k = 1; k < hops.size(); k++)
+        {
+            int a = hops[k - 1];
+            int b = hops[k];
+            int ca = clusterOf(costMap->cellX(a), costMap->cellY(a));
+            int cb = clusterOf(costMap->cellX(b), costMap->cellY(b));
+            if (ca == cb)
+            {
+                if (a == b)
+                    continue;
+                searchCluster(clusters[ca], a, b, false);
+                std::vector<int> part;
+                appendScratchPath(b, part);
+                cells.insert(cells.end(), part.begin() + 1, part.end());
+            }
+            else
+            {
+                cells.push_back(b); // linked neighbours across a border
+            }
+        }
+        return true;
+    }
+
+private:
+    template <typename F>
+    void forEachNeighborCluster(int id, F func) const
+    {
+        int cx = id % clustersX;
+        int cy = id / clustersX;
+        for (int dy = -1; dy <= 1; dy++)
+        {
+            for (int dx = -1; dx <= 1; dx++)
+            {
+                int nx = cx + dx;
+                int ny = cy + dy;
+                if ((dx || dy) && nx >= 0 && nx < clustersX && ny >= 0 && ny < clustersY)
+                {
+                    func(ny * clustersX + nx);
+                }
+            }
+        }
+    }
+
+    // Entrance transitions between two clusters: one per contiguous run of border crossings.
+    void computeTransitions(int a, int b)
+    {
+        if (a > b)
+            std::swap(a, b);
+        const Cluster &ca = clusters[a];
+        const CostLayer grid = costMap->getCostGrid();
+
+        std::vector<std::pair<int, int>> crossings;
+        for (int y = ca.y0; y < ca.y1; y++)
+        {
+            for (int x = ca.x0; x < ca.x1; x++)
+            {
+                bool perimeter = x == ca.x0 || x == ca.x1 - 1 || y == ca.y0 || y == ca.y1 - 1;
+                if (!perimeter || grid[costMap->index(x, y)] <= 0)
+                    continue;
+                for (int i = 0; i < 6; i++)
+                {
+                    auto [nx, ny] = costMap->getNeighbor(x, y, i);
+                    if (!costMap->isWalkable(nx, ny) || clusterOf(nx, ny) != b)
+                        continue;
+                    crossings.push_back({costMap->index(x, y), costMap->index(nx, ny)});
+                }
+            }
+        }
+
+        std::vector<std::pair<int, int>> &list = transitions[{a, b}];
+        list.clear();
+        // crossings are in row-major order of the first cell, so a run is a chain of adjacent cells;
+        // the cells across must chain too, or one side may hold regions the other side joins
+        auto adjacent = [this](int p, int q)
+        { return CostMap::hexDistance(costMap->cellX(p), costMap->cellY(p), costMap->cellX(q), costMap->cellY(q)) <= 1; };
+        size_t runStart = 0;
+        for (size_t i = 1; i <= crossings.size(); i++)
+        {
+            bool split = i == crossings.size();
+            if (!split)
+            {
+                split = !adjacent(crossings[i - 1].first, crossings[i].first) ||
+                        !adjacent(crossings[i - 1].second, crossings[i].second);
+            }
+            if (split)
+            {
+                list.push_back(crossings[(runStart + i - 1) / 2]);
+                runStart = i;
+            }
+        }
+    }
+
+    void buildEntrances(int id)
+    {
+        Cluster &c = clusters[id];
+        for (int cell : c.entrances)
+        {
+            entranceSlot[cell] = -1;
+        }
+        c.entrances.clear();
+        c.links.clear();
+
+        auto addLink = [this, &c](int cell, int other)
+        {
+            int slot = entranceSlot[cell];
+            if (slot < 0)
+            {
+                slot = (int)c.entrances.size();
+                entranceSlot[cell] = slot;
+                c.entrances.push_back(cell);
+                c.links.emplace_back();
+            }
+            c.links[slot].push_back(other);
+        };
+
+        forEachNeighborCluster(id, [this, id, &addLink](int other)
+                               {
+            auto it = transitions.find({std::min(id, other), std::max(id, other)});
+            if (it == transitions.end())
+                return;
+            for (auto &t : it->second)
+            {
+                if (id < other)
+                    addLink(t.first, t.second);
+                else
+                    addLink(t.second, t.first);
+            } });
+    }
+
+    void buildIntraCosts(int id)
+    {
+        Cluster &c = clusters[id];
+        const int n = (int)c.entrances.size();
+        c.dist.assign(n * n, -1);
+        for (int i = 0; i < n; i++)
+        {
+            searchCluster(c, c.entrances[i], -1, false);
+            for (int j = 0; j < n; j++)
+            {
+                c.dist[i * n + j] = scratchDistance(c, c.entrances[j]);
+            }
+        }
+    }
+
+    int localIndex(const Cluster &c, int idx) const
+    {
+        return (costMap->cellY(idx) - c.y0) * (c.x1 - c.x0) + (costMap->cellX(idx) - c.x0);
+    }
+
+    int scratchDistance(const Cluster &c, int idx) const
+    {
+        int l = localIndex(c, idx);
+        return sSeen[l] == sGen ? sDist[l] : -1;
+    }
+
+    // Path from the last searchCluster() source to idx, appended in forward order.
+    void appendScratchPath(int idx, std::vector<int> &cells) const
+    {
+        // parents are stored as cell indices; walk back then reverse the appended tail
+        size_t first = cells.size();
+        for (int node = idx; node != -1;)
+        {
+            cells.push_back(node);
+            int x = costMap->cellX(node);
+            int y = costMap->cellY(node);
+            const Cluster &c = clusters[clusterOf(x, y)];
+            node = sParent[localIndex(c, node)];
+        }
+        std::reverse(cells.begin() + first, cells.end());
+    }
+
+    // Dijkstra (target < 0) or A* (target >= 0) from source, never leaving cluster c.
+    // Moving into a cell costs that cell's cost; reverse walks edges backwards, so
+    // distances are then costs from each cell to source.
+    bool searchCluster(const Cluster &c, int source, int target, bool reverse)
+    {
+        const size_t n = static_cast<size_t>(c.x1 - c.x0) * (c.y1 - c.y0);
+        if (sSeen.size() < n)
+        {
+            sDist.resize(n);
+            sParent.resize(n);
+            sSeen.assign(n, 0);
+            sClosed.assign(n, 0);
+            sGen = 0;
+        }
+        if (++sGen == 0)
+        {
+            std::fill(sSeen.begin(), sSeen.end(), 0);
+            std::fill(sClosed.begin(), sClosed.end(), 0);
+            sGen = 1;
+        }
+        sHeap.clear();
+
+        const CostLayer grid = costMap->getCostGrid();
+        const int tx = target >= 0 ? costMap->cellX(target) : 0;
+        const int ty = target >= 0 ? costMap->cellY(target) : 0;
+        auto h = [target, tx, ty](int x, int y)
+        {
+            return target >= 0 ? CostMap::hexDistance(x, y, tx, ty) * CostMap::DEFAULT_COST : 0;
+        };
+        auto cmp = std::greater<std::pair<int, int>>();
+
+        int l = localIndex(c, source);
+        sSeen[l] = sGen;
+        sDist[l] = 0;
+        sParent[l] = -1;
+        sHeap.push_back({h(costMap->cellX(source), costMap->cellY(source)), source});
+
+        while (!sHeap.empty())
+        {
+            std::pop_heap(sHeap.begin(), sHeap.end(), cmp);
+            int idx = sHeap.back().second;
+            sHeap.pop_back();
+            int li = localIndex(c, idx);
+            if (sClosed[li] == sGen)
+                continue;
+            sClosed[li] = sGen;
+            if (idx == target)
+                return true;
+
+            int x = costMap->cellX(idx);
+            int y = costMap->cellY(idx);
+            const int *delta = costMap->getNeighborDeltas(y);
+            for (int i = 0; i < 6; i++)
+            {
+                int nIdx = idx + delta[i];
+                int cost = grid[nIdx];
+                if (cost <= 0)
+                    continue;
+                auto [nx, ny] = costMap->getNeighbor(x, y, i);
+                if (nx < c.x0 || nx >= c.x1 || ny < c.y0 || ny >= c.y1)
+                    continue;
+                int nl = localIndex(c, nIdx);
+                int nd = sDist[li] + (reverse ? grid[idx] : cost);
+                if (sSeen[nl] != sGen || nd < sDist[nl])
+                {
+                    sSeen[nl] = sGen;
+                    sDist[nl] = nd;
+                    sParent[nl] = idx;
+                    sHeap.push_back({nd + h(nx, ny), nIdx});
+                    std::push_heap(sHeap.begin(), sHeap.end(), cmp);
+                }
+            }
+        }
+        return target < 0;
+    }
+};
@@ -0,0 +1,321 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <climits>
+#include <algorithm>
+#include <OgreFrameListener.h>
+#include "CostMap.h"
+#include "FlowField.h"
+#include "PathWorkerPool.h"
+
+// ALT heuristic: exact costs from every cell to a few landmark cells, turned
+// into a lower bound by the triangle inequality. With T(v) the cost from v to
+// landmark L:
+//   cost(n, goal) >= T(n) - T(goal)
+//   cost(n, goal) >= T(goal) - T(n) + cost(goal) - cost(n)
+// (the second because reversing a path swaps which end cell is paid for).
+// The best landmark bound, and never less than hex distance, is used by
+// CostMap::findPath once this is set as the map's Heuristic.
+//
+// Costs are stored as uint16 interleaved per cell (all landmarks of a cell in
+// one cache line); costs that do not fit count as unknown and are skipped.
+// Any setCost() makes the tables stale and estimates fall back to hex
+// distance until new ones are built. As a FrameListener it starts that build
+// on the pool once the map has been left alone for refreshDelay seconds, and
+// publishes the result on a later frame unless the map changed meanwhile.
+// Tables are immutable once built: each search pins the current ones through
+// snapshot(), so publishing never pulls them from under a running search.
+class LandmarkHeuristic : public CostMap::Listener, public CostMap::Heuristic, public Ogre::FrameListener
+{
+    static constexpr uint16_t UNKNOWN = 0xFFFF;
+
+    // One set of landmarks and their cost tables; no landmarks: hex distance only.
+    class Tables : public CostMap::Heuristic
+    {
+    public:
+        const CostMap *costMap;
+        int count;
+        std::vector<int> landmarks;       // cell indices
+        std::vector<uint16_t> toLandmark; // [cell * count + landmark]
+
+        Tables(const CostMap *costMap, int count) : costMap(costMap), count(count)
+        {
+        }
+
+        int estimate(int idx, int goalIdx) const override
+        {
+            int best = CostMap::hexDistance(costMap->cellX(idx), costMap->cellY(idx),
+                                            costMap->cellX(goalIdx), costMap->cellY(goalIdx)) *
+                       CostMap::DEFAULT_COST;
+            if (landmarks.empty())
+            {
+                return best;
+            }
+            const CostLayer grid = costMap->getCostGrid();
+            const int costDiff = grid[goalIdx] - grid[idx];
+            const uint16_t *n = &toLandmark[static_cast<size_t>(idx) * count];
+            const uint16_t *t = &toLandmark[static_cast<size_t>(goalIdx) * count];
+            for (int l = 0; l < count; l++)
+            {
+                if (n[l] == UNKNOWN || t[l] == UNKNOWN)
+                    continue;
+                best = std::max(best, std::max(n[l] - t[l], t[l] - n[l] + costDiff));
+            }
+            return best;
+        }
+
+        // Spread landmarks evenly along the map border, each snapped to the
+        // nearest walkable cell: bounds are tightest for goals "behind" the
+        // search as seen from a landmark, and the border is behind everything.
+        void placeLandmarks()
+        {
+            landmarks.clear();
+            const int w = costMap->getWidth();
+            const int h = costMap->getHeight();
+            const int perimeter = 2 * (w + h);
+            for (int l = 0; l < count; l++)
+            {
+                int p = static_cast<int>(static_cast<long long>(perimeter) * l / count);
+                int px, py;
+                if (p < w)
+                {
+                    px = p, py = 0;
+                }
+                else if ((p -= w) < h)
+                {
+                    px = w - 1, py = p;
+                }
+                else if ((p -= h) < w)
+                {
+                    px = w - 1 - p, py = h - 1;
+                }
+                else
+                {
+                    px = 0, py = h - 1 - (p - w);
+                }
+
+                int best = -1;
+                int bestDist = INT_MAX;
+                for (int y = 0; y < h; y++)
+                {
+                    for (int x = 0; x < w; x++)
+                    {
+                        int d = CostMap::hexDistance(x, y, px, py);
+                        if (d < bestDist && costMap->isWalkable(x, y))
+                        {
+                            bestDist = d;
+                            best = costMap->index(x, y);
+                        }
+                    }
+                }
+                if (best >= 0 && std::find(landmarks.begin(), landmarks.end(), best) == landmarks.end())
+                {
+                    landmarks.push_back(best);
+                }
+            }
+            toLandmark.assign(costMap->getCostGrid().size() * count, UNKNOWN);
+        }
+
+        // Column l of the table; columns are filled independently, in parallel.
+        void build(int l)
+        {
+            const int idx = landmarks[l];
+            FlowField field(*costMap, costMap->cellX(idx), costMap->cellY(idx));
+            for (int y = 0; y < costMap->getHeight(); y++)
+            {
+                for (int x = 0; x < costMap->getWidth(); x++)
+                {
+                    int c = field.getCostToGoal(x, y);
+                    if (c >= 0 && c < UNKNOWN)
+                    {
+                        toLandmark[static_cast<size_t>(costMap->index(x, y)) * count + l] = static_cast<uint16_t>(c);
+                    }
+                }
+            }
+        }
+    };
+
+    // Tables under construction on the pool.
+    struct Build
+    {
+        uint32_t version; // of the map when started
+        std::shared_ptr<Tables> tables;
+        std::atomic<int> remaining{1};
+        std::mutex mtx;
+        std::condition_variable cv;
+
+        bool isDone() const
+        {
+            return remaining.load(std::memory_order_acquire) == 0;
+        }
+
+        void finishOne()
+        {
+            if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                cv.notify_all();
+            }
+        }
+
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [this]()
+                    { return isDone(); });
+        }
+    };
+
+    CostMap *costMap;
+    PathWorkerPool *pool;
+    int count;
+    std::shared_ptr<const Tables> tables;  // published, read via std::atomic_load
+    std::shared_ptr<const Tables> hexOnly; // answers while stale
+    std::shared_ptr<Build> pending;        // render thread only
+    std::atomic<bool> stale{true};
+    uint32_t version = 0; // bumped by setCost()
+    float refreshDelay = 0.5f;
+    float sinceChange = 0.0f;
+
+public:
+    // pool: builds the landmark tables in the background, null to build them in frameStarted().
+    LandmarkHeuristic(CostMap *costMap, int count = 8, PathWorkerPool *pool = nullptr)
+        : costMap(costMap), pool(pool), count(count), hexOnly(std::make_shared<Tables>(costMap, 0))
+    {
+        tables = hexOnly;
+        refresh();
+        costMap->addListener(this);
+        costMap->setHeuristic(this);
+    }
+
+    ~LandmarkHeuristic()
+    {
+        costMap->setHeuristic(nullptr);
+        costMap->removeListener(this);
+        if (pending)
+        {
+            pending->wait(); // its tasks read the map
+        }
+    }
+
+    bool isStale() const
+    {
+        return stale.load();
+    }
+
+    void setRefreshDelay(float seconds)
+    {
+        this->refreshDelay = seconds;
+    }
+
+    // Landmarks of the published tables; valid until the next frameStarted().
+    const std::vector<int> &getLandmarks() const
+    {
+        return tables->landmarks;
+    }
+
+    void costChanged(int /*x*/, int /*y*/, int /*oldCost*/, int /*newCost*/) override
+    {
+        stale.store(true);
+        version++;
+        sinceChange = 0.0f;
+    }
+
+    bool frameStarted(const Ogre::FrameEvent &evt) override
+    {
+        if (pending && pending->isDone())
+        {
+            if (pending->version == version)
+            {
+                publish(pending->tables);
+            }
+            pending.reset(); // else outdated: built again below
+        }
+        if (stale.load() && !pending)
+        {
+            sinceChange += evt.timeSinceLastFrame;
+            if (sinceChange >= refreshDelay)
+            {
+                start();
+            }
+        }
+        return true;
+    }
+
+    int estimate(int idx, int goalIdx) const override
+    {
+        return snapshot()->estimate(idx, goalIdx);
+    }
+
+    std::shared_ptr<const CostMap::Heuristic> snapshot() const override
+    {
+        if (stale.load())
+        {
+            return hexOnly;
+        }
+        return std::atomic_load(&tables);
+    }
+
+    // Re-place the landmarks and rebuild their tables now, blocking until done.
+    void refresh()
+    {
+        if (pending)
+        {
+            pending->wait();
+            pending.reset();
+        }
+        std::shared_ptr<Build> build = start();
+        if (build)
+        {
+            build->wait();
+            publish(build->tables);
+            pending.reset();
+        }
+    }
+
+private:
+    // Starts building new tables; without a pool they are built and published here.
+    std::shared_ptr<Build> start()
+    {
+        std::shared_ptr<Build> build = std::make_shared<Build>();
+        build->version = version;
+        build->tables = std::make_shared<Tables>(costMap, count);
+        if (!pool)
+        {
+            build->tables->placeLandmarks();
+            for (int l = 0; l < static_cast<int>(build->tables->landmarks.size()); l++)
+            {
+                build->tables->build(l);
+            }
+            publish(build->tables);
+            return nullptr;
+        }
+        PathWorkerPool *workers = pool;
+        pool->post([build, workers]()
+                   {
+            Tables &t = *build->tables;
+            t.placeLandmarks();
+            const int placed = static_cast<int>(t.landmarks.size());
+            build->remaining.fetch_add(placed, std::memory_order_relaxed);
+            for (int l = 0; l < placed; l++)
+            {
+                workers->post([build, l]()
+                              {
+                    build->tables->build(l);
+                    build->finishOne(); });
+            }
+            build->finishOne(); });
+        pending = build;
+        return build;
+    }
+
+    void publish(std::shared_ptr<const Tables> next)
+    {
+        std::atomic_store(&tables, std::move(next));
+        stale.store(false);
+    }
+};
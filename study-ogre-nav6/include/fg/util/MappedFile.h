@@ -0,0 +1,124 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// A whole file mapped copy-on-write: pages are read from the file on first
+// touch, writes go to private copies of the touched pages and never reach
+// the file. Unmapped when the last reference goes.
+class MappedFile
+{
+    uint8_t *base = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+    MappedFile()
+    {
+    }
+
+public:
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // Null if the file is missing, empty or cannot be mapped.
+    static std::shared_ptr<MappedFile> open(const std::string &path)
+    {
+        std::shared_ptr<MappedFile> mf(new MappedFile());
+#ifdef _WIN32
+        mf->file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (mf->file == INVALID_HANDLE_VALUE)
+        {
+            return nullptr;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(mf->file, &size) || size.QuadPart == 0)
+        {
+            return nullptr;
+        }
+        mf->mapping = CreateFileMappingA(mf->file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        if (!mf->mapping)
+        {
+            return nullptr;
+        }
+        mf->base = static_cast<uint8_t *>(MapViewOfFile(mf->mapping, FILE_MAP_COPY, 0, 0, 0));
+        if (!mf->base)
+        {
+            return nullptr;
+        }
+        mf->length = static_cast<size_t>(size.QuadPart);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return nullptr;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0)
+        {
+            ::close(fd);
+            return nullptr;
+        }
+        void *p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        ::close(fd); // the mapping keeps its own reference
+        if (p == MAP_FAILED)
+        {
+            return nullptr;
+        }
+        mf->base = static_cast<uint8_t *>(p);
+        mf->length = static_cast<size_t>(st.st_size);
+#endif
+        return mf;
+    }
+
+    ~MappedFile()
+    {
+#ifdef _WIN32
+        if (base)
+        {
+            UnmapViewOfFile(base);
+        }
+        if (mapping)
+        {
+            CloseHandle(mapping);
+        }
+        if (file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(file);
+        }
+#else
+        if (base)
+        {
+            munmap(base, length);
+        }
+#endif
+    }
+
+    uint8_t *data() const
+    {
+        return base;
+    }
+
+    size_t size() const
+    {
+        return length;
+    }
+};
@@ -0,0 +1,91 @@
+#pragma once
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include "CostMap.h"
+#include "PathWorkerPool.h"
+
+struct MovementRangeQuery
+{
+    CellKey origin;
+    int budget; // movement points
+};
+
+// Cells a unit can reach within its budget, kept after the search context is
+// reused: parallel arrays in order of cost, origin first.
+struct MovementRange
+{
+    CellKey origin;
+    int budget = 0;
+    std::vector<int> cells;   // CostMap::index() of each cell
+    std::vector<int> costs;   // movement points spent to get there
+    std::vector<int> parents; // index of the cell before, -1 for the origin
+
+    // Copies the range found last by CostMap::findReachable() with ctx.
+    void assign(const PathSearchContext &ctx, CellKey origin, int budget)
+    {
+        this->origin = origin;
+        this->budget = budget;
+        cells = ctx.chain;
+        costs.resize(cells.size());
+        parents.resize(cells.size());
+        for (size_t i = 0; i < cells.size(); i++)
+        {
+            costs[i] = ctx.gScore[cells[i]];
+            parents[i] = ctx.parent[cells[i]];
+        }
+    }
+
+    // The cells as keys, e.g. for CellMarkStateControl::setMarks().
+    std::vector<CellKey> getCellKeys(const CostMap &costMap) const
+    {
+        std::vector<CellKey> keys;
+        keys.reserve(cells.size());
+        for (int idx : cells)
+        {
+            keys.push_back({costMap.cellX(idx), costMap.cellY(idx)});
+        }
+        return keys;
+    }
+
+    // Movement ranges of many units. With a pool, units are spread over its
+    // workers, each searching with its thread's PathSearchContext::local();
+    // called on one of those workers, it computes them all itself.
+    static void computeAll(const CostMap &costMap, const std::vector<MovementRangeQuery> &queries,
+                           std::vector<MovementRange> &ranges, PathWorkerPool *pool = nullptr)
+    {
+        ranges.resize(queries.size());
+        auto compute = [&costMap, &queries, &ranges](size_t i)
+        {
+            const MovementRangeQuery &q = queries[i];
+            PathSearchContext &ctx = PathSearchContext::local();
+            costMap.findReachable(q.origin.first, q.origin.second, q.budget, ctx);
+            ranges[i].assign(ctx, q.origin, q.budget);
+        };
+        if (!pool || queries.size() < 2 || pool->isWorkerThread())
+        {
+            for (size_t i = 0; i < queries.size(); i++)
+            {
+                compute(i);
+            }
+            return;
+        }
+        std::mutex doneMtx;
+        std::condition_variable doneCv;
+        size_t running = queries.size();
+        for (size_t i = 0; i < queries.size(); i++)
+        {
+            pool->post([&, i]()
+                       {
+                compute(i);
+                std::lock_guard<std::mutex> lock(doneMtx);
+                if (--running == 0)
+                {
+                    doneCv.notify_all();
+                } });
+        }
+        std::unique_lock<std::mutex> lock(doneMtx);
+        doneCv.wait(lock, [&running]()
+                    { return running == 0; });
+    }
+};
@@ -0,0 +1,98 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include "CostMap.h"
+
+// One start/goal pair of a MovingAI scenario (.scen) file.
+struct MovingAiQuery
+{
+    int startX, startY, goalX, goalY;
+    double optimal; // as listed: the octile optimum, not comparable to hex costs
+};
+
+// Maps and scenarios in the MovingAI benchmark format
+// (https://movingai.com/benchmarks/formats.html). The grid is read onto the
+// hex layout as is: same cells, hex adjacency. Passable terrain gets
+// DEFAULT_COST, swamp swampCost; out of bounds, trees and water are obstacles.
+class MovingAiFile
+{
+public:
+    // New map, or null if the file cannot be read.
+    static CostMap *loadMap(const std::string &path, int swampCost = 3)
+    {
+        std::ifstream in(path);
+        std::string word, type;
+        int width = -1, height = -1;
+        while (in >> word && word != "map")
+        {
+            if (word == "type")
+                in >> type;
+            else if (word == "width")
+                in >> width;
+            else if (word == "height")
+                in >> height;
+        }
+        if (word != "map" || width <= 0 || height <= 0)
+        {
+            return nullptr;
+        }
+        CostMap *costMap = new CostMap(width, height);
+        std::string line;
+        std::getline(in, line); // rest of the "map" line
+        for (int y = 0; y < height; y++)
+        {
+            if (!std::getline(in, line))
+            {
+                delete costMap;
+                return nullptr;
+            }
+            for (int x = 0; x < width; x++)
+            {
+                const char c = x < static_cast<int>(line.size()) ? line[x] : '@';
+                costMap->setCost(x, y, costOf(c, swampCost));
+            }
+        }
+        return costMap;
+    }
+
+    // Appends the scenario's queries; false if the file cannot be read.
+    static bool loadScenario(const std::string &path, std::vector<MovingAiQuery> &queries)
+    {
+        std::ifstream in(path);
+        if (!in)
+        {
+            return false;
+        }
+        std::string line;
+        while (std::getline(in, line))
+        {
+            // bucket  map  width  height  startX  startY  goalX  goalY  optimal
+            std::istringstream fields(line);
+            int bucket, width, height;
+            std::string map;
+            MovingAiQuery q;
+            if (fields >> bucket >> map >> width >> height >> q.startX >> q.startY >> q.goalX >> q.goalY >> q.optimal)
+            {
+                queries.push_back(q);
+            }
+        }
+        return true;
+    }
+
+private:
+    static int costOf(char c, int swampCost)
+    {
+        switch (c)
+        {
+        case '.':
+        case 'G':
+            return CostMap::DEFAULT_COST;
+        case 'S':
+            return swampCost;
+        default: // '@', 'O', 'T', 'W'
+            return CostMap::OBSTACLE;
+        }
+    }
+};
@@ -0,0 +1,158 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include "BitOps.h"
+
+// Units standing on cells, kept apart from the terrain costs: moving a unit
+// is two counter updates and at most two bit flips, and nothing that listens
+// to CostMap::setCost() (components, landmarks) is disturbed. What does care
+// which cells are blocked, like PathCache, adds a Listener here.
+// A cell is blocked once as many units stand on it as its capacity allows.
+// Cells are indexed like CostMap::index(), so searches test a neighbour with
+// the index they already have, see CostMap::setOccupancy(). Units are moved
+// on one thread; the blocked bits may be read by path workers meanwhile.
+class OccupancyLayer
+{
+public:
+    // Told on the moving thread whenever a cell becomes blocked or free.
+    class Listener
+    {
+    public:
+        virtual void blockedChanged(int x, int y, bool blocked) = 0;
+    };
+
+private:
+    int width, height, stride;
+    std::vector<uint16_t> counts;
+    std::unique_ptr<std::atomic<uint64_t>[]> blocked; // bit per cell index
+    size_t words;
+    uint16_t capacity;
+    std::vector<Listener *> listeners;
+
+public:
+    OccupancyLayer(int width, int height, int capacity = 1)
+        : width(width), height(height), stride(width + 2),
+          counts(static_cast<size_t>(width + 2) * (height + 2), 0),
+          blocked(new std::atomic<uint64_t>[(counts.size() + 63) / 64]), words((counts.size() + 63) / 64),
+          capacity(static_cast<uint16_t>(std::max(capacity, 1)))
+    {
+        clearBlocked();
+    }
+
+    int index(int x, int y) const
+    {
+        return (y + 1) * stride + (x + 1);
+    }
+
+    void addListener(Listener *l)
+    {
+        listeners.push_back(l);
+    }
+
+    void removeListener(Listener *l)
+    {
+        listeners.erase(std::remove(listeners.begin(), listeners.end(), l), listeners.end());
+    }
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    int getCapacity() const { return capacity; }
+
+    int getCount(int x, int y) const
+    {
+        return inside(x, y) ? counts[index(x, y)] : 0;
+    }
+
+    bool isBlocked(int idx) const
+    {
+        return (blocked[idx >> 6].load(std::memory_order_relaxed) >> (idx & 63)) & 1;
+    }
+
+    bool isBlocked(int x, int y) const
+    {
+        return inside(x, y) && isBlocked(index(x, y));
+    }
+
+    void add(int x, int y)
+    {
+        if (!inside(x, y))
+        {
+            return;
+        }
+        const int idx = index(x, y);
+        if (++counts[idx] == capacity)
+        {
+            blocked[idx >> 6].fetch_or(uint64_t(1) << (idx & 63), std::memory_order_relaxed);
+            notify(x, y, true);
+        }
+    }
+
+    void remove(int x, int y)
+    {
+        if (!inside(x, y))
+        {
+            return;
+        }
+        const int idx = index(x, y);
+        if (counts[idx] == 0)
+        {
+            return;
+        }
+        if (counts[idx]-- == capacity)
+        {
+            blocked[idx >> 6].fetch_and(~(uint64_t(1) << (idx & 63)), std::memory_order_relaxed);
+            notify(x, y, false);
+        }
+    }
+
+    void move(int fromX, int fromY, int toX, int toY)
+    {
+        if (fromX != toX || fromY != toY)
+        {
+            remove(fromX, fromY);
+            add(toX, toY);
+        }
+    }
+
+    void clear()
+    {
+        std::fill(counts.begin(), counts.end(), 0);
+        if (!listeners.empty())
+        {
+            for (size_t i = 0; i < words; i++)
+            {
+                for (uint64_t bits = blocked[i].load(std::memory_order_relaxed); bits; bits &= bits - 1)
+                {
+                    const int idx = static_cast<int>(i * 64) + BitOps::lowestBit(bits);
+                    notify(idx % stride - 1, idx / stride - 1, false);
+                }
+            }
+        }
+        clearBlocked();
+    }
+
+private:
+    void notify(int x, int y, bool isBlocked)
+    {
+        for (Listener *l : listeners)
+        {
+            l->blockedChanged(x, y, isBlocked);
+        }
+    }
+
+    void clearBlocked()
+    {
+        for (size_t i = 0; i < words; i++)
+        {
+            blocked[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    bool inside(int x, int y) const
+    {
+        return x >= 0 && x < width && y >= 0 && y < height;
+    }
+};
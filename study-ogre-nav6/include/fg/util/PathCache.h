@@ -0,0 +1,243 @@
+#pragma once
+#include <vector>
+#include <list>
+#include <mutex>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
+#include "CostMap.h"
+#include "OccupancyLayer.h"
+
+// LRU cache in front of CostMap::findPath for repeated (start, goal) queries.
+// The map is divided into regionSize x regionSize regions, each with a version
+// bumped by setCost(). A cached path remembers the versions of the regions it
+// crosses and is dropped only when one of those changed; a cached "no path"
+// result is dropped on any change. A path kept this way is still walkable at
+// its old cost, though a cheaper route may have opened elsewhere.
+// Lookups may run on several threads; the map must not change meanwhile.
+// Units move without setCost() and while searches run, so the map's
+// OccupancyLayer must be passed to setOccupancy(): blocking or freeing a cell
+// bumps its region like setCost(), and a path whose regions changed during
+// its own search is returned but not cached. While the map has an occupancy
+// layer the cache does not listen to, every lookup searches.
+class PathCache : public CostMap::Listener, public OccupancyLayer::Listener
+{
+public:
+    struct Stats
+    {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t invalidated = 0; // found but stale
+        size_t evictions = 0;   // dropped for the memory cap
+    };
+
+private:
+    struct Entry
+    {
+        uint64_t key;
+        CellPath path;
+        std::vector<std::pair<int, uint32_t>> regions; // (region, version when cached)
+        uint32_t mapVersion;                           // checked for empty paths only
+        size_t bytes;
+    };
+
+    CostMap *costMap;
+    int regionSize;
+    int regionsX;
+    std::vector<uint32_t> regionVersion; // mapVersion at the region's last change
+    uint32_t mapVersion = 0;              // bumped by every change
+    OccupancyLayer *occupancy = nullptr;
+
+    size_t maxBytes;
+    size_t bytes = 0;
+    std::list<Entry> lru; // most recent first
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> entries;
+    Stats stats;
+    std::mutex mtx;
+
+public:
+    PathCache(CostMap *costMap, size_t maxBytes = 1 << 20, int regionSize = 16)
+        : costMap(costMap), regionSize(regionSize), maxBytes(maxBytes)
+    {
+        regionsX = (costMap->getWidth() + regionSize - 1) / regionSize;
+        int regionsY = (costMap->getHeight() + regionSize - 1) / regionSize;
+        regionVersion.assign(regionsX * regionsY, 0);
+        costMap->addListener(this);
+    }
+
+    ~PathCache()
+    {
+        setOccupancy(nullptr);
+        costMap->removeListener(this);
+    }
+
+    // The layer the map searches around, see CostMap::setOccupancy().
+    void setOccupancy(OccupancyLayer *o)
+    {
+        if (occupancy)
+        {
+            occupancy->removeListener(this);
+        }
+        occupancy = o;
+        if (occupancy)
+        {
+            occupancy->addListener(this);
+        }
+        clear();
+    }
+
+    Stats getStats()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        return stats;
+    }
+
+    size_t getBytes()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        return bytes;
+    }
+
+    void costChanged(int x, int y, int /*oldCost*/, int /*newCost*/) override
+    {
+        changed(x, y);
+    }
+
+    void blockedChanged(int x, int y, bool /*blocked*/) override
+    {
+        changed(x, y);
+    }
+
+    CellPath findPath(CellKey start, CellKey end)
+    {
+        CellPath path;
+        findPath(start.first, start.second, end.first, end.second, PathSearchContext::local(), path);
+        return path;
+    }
+
+    // Same contract as the matching CostMap::findPath overload.
+    bool findPath(int startX, int startY, int endX, int endY, PathSearchContext &ctx, CellPath &path,
+                  PathSearchMode mode = PathSearchMode::FORWARD)
+    {
+        if (costMap->getOccupancy() && costMap->getOccupancy() != occupancy)
+        {
+            return costMap->findPath(startX, startY, endX, endY, ctx, path, mode);
+        }
+        // cell indices stay below 2^31, leaving a bit for the mode
+        const uint64_t key = (static_cast<uint64_t>(costMap->index(startX, startY)) << 33) |
+                             (static_cast<uint64_t>(mode == PathSearchMode::BIDIRECTIONAL) << 32) |
+                             static_cast<uint32_t>(costMap->index(endX, endY));
+        uint32_t searchedAt;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            auto it = entries.find(key);
+            if (it != entries.end())
+            {
+                if (isCurrent(*it->second))
+                {
+                    lru.splice(lru.begin(), lru, it->second);
+                    path = it->second->path;
+                    stats.hits++;
+                    return !path.empty();
+                }
+                stats.invalidated++;
+                erase(it->second);
+            }
+            stats.misses++;
+            searchedAt = mapVersion;
+        }
+
+        bool found = costMap->findPath(startX, startY, endX, endY, ctx, path, mode);
+
+        Entry entry;
+        entry.key = key;
+        entry.path = path;
+        for (auto cell : path)
+        {
+            entry.regions.push_back({regionOf(cell.first, cell.second), 0});
+        }
+        std::sort(entry.regions.begin(), entry.regions.end());
+        entry.regions.erase(std::unique(entry.regions.begin(), entry.regions.end()), entry.regions.end());
+        entry.regions.shrink_to_fit();
+        entry.bytes = sizeof(Entry) + 4 * sizeof(void *) + entry.path.getBytes() - sizeof(CellPath) +
+                      entry.regions.size() * sizeof(entry.regions[0]);
+
+        std::lock_guard<std::mutex> lock(mtx);
+        for (auto &r : entry.regions)
+        {
+            r.second = regionVersion[r.first];
+            if (changedSince(r.second, searchedAt))
+            {
+                return found; // a unit moved through it meanwhile
+            }
+        }
+        if (entry.path.empty() && mapVersion != searchedAt)
+        {
+            return found;
+        }
+        entry.mapVersion = mapVersion;
+        auto it = entries.find(key);
+        if (it != entries.end())
+        {
+            erase(it->second); // another thread cached it meanwhile
+        }
+        bytes += entry.bytes;
+        lru.push_front(std::move(entry));
+        entries[key] = lru.begin();
+        while (bytes > maxBytes && lru.size() > 1)
+        {
+            erase(std::prev(lru.end()));
+            stats.evictions++;
+        }
+        return found;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        lru.clear();
+        entries.clear();
+        bytes = 0;
+    }
+
+private:
+    void changed(int x, int y)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        regionVersion[regionOf(x, y)] = ++mapVersion;
+    }
+
+    // Wrap-safe: version was stamped after searchedAt.
+    static bool changedSince(uint32_t version, uint32_t searchedAt)
+    {
+        return static_cast<int32_t>(version - searchedAt) > 0;
+    }
+
+    int regionOf(int x, int y) const
+    {
+        return (y / regionSize) * regionsX + x / regionSize;
+    }
+
+    bool isCurrent(const Entry &e) const
+    {
+        if (e.path.empty())
+        {
+            return e.mapVersion == mapVersion;
+        }
+        for (const auto &r : e.regions)
+        {
+            if (regionVersion[r.first] != r.second)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void erase(std::list<Entry>::iterator it)
+    {
+        bytes -= it->bytes;
+        entries.erase(it->key);
+        lru.erase(it);
+    }
+};
@@ -0,0 +1,165 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+
+// === NavNode structure ===
+struct NavNode
+{
+    int x, y;
+    int g, h;
+    int idx; // linear index into CostMap::costGrid
+    int f() const { return g + h; }
+    bool operator>(const NavNode &other) const { return f() > other.f(); }
+};
+
+// Open list implementations for PathSearchContext. Both share one interface:
+//   reset(cells, maxStep)  prepare for a new search
+//   push(node)             node is not in the list yet
+//   decrease(node, oldF)   node is in the list with key oldF, node.f() < oldF
+//   pop()                  remove a node with the smallest f
+//   minF()                 smallest f in a non-empty list, without removing it
+// maxStep bounds how far a pushed f may lie above the current minimum.
+// decrease() leaves the old entry behind; the caller skips it when it comes
+// out again (closed check). Among equal f the entry pushed last comes out
+// first, in both lists, so the choice of list never changes a path.
+
+// Binary heap ordered by f, then by push order.
+class BinaryHeapOpenList
+{
+    struct Entry
+    {
+        uint64_t key; // f, then later pushes first
+        NavNode node;
+        bool operator>(const Entry &other) const { return key > other.key; }
+    };
+
+    std::vector<Entry> heap;
+    uint32_t seq = 0;
+
+public:
+    void reset(size_t /*cells*/, int /*maxStep*/)
+    {
+        heap.clear();
+        seq = 0;
+    }
+
+    bool empty() const
+    {
+        return heap.empty();
+    }
+
+    void push(const NavNode &node)
+    {
+        heap.push_back({(static_cast<uint64_t>(static_cast<uint32_t>(node.f())) << 32) | ~seq++, node});
+        std::push_heap(heap.begin(), heap.end(), std::greater<Entry>());
+    }
+
+    void decrease(const NavNode &node, int /*oldF*/)
+    {
+        push(node);
+    }
+
+    NavNode pop()
+    {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<Entry>());
+        NavNode node = heap.back().node;
+        heap.pop_back();
+        return node;
+    }
+
+    // may belong to a stale duplicate, which only makes it a lower bound
+    int minF() const
+    {
+        return heap.front().node.f();
+    }
+};
+
+// Dial's bucket queue: a ring of per-f buckets, valid because costs and the
+// hex-distance heuristic are small integers and f never decreases along a
+// search (consistent heuristic). Each bucket is a stack, which gives the
+// heap's order among equal f for free. Buckets keep their capacity across
+// searches.
+class BucketOpenList
+{
+    std::vector<std::vector<NavNode>> buckets;
+    int mask = 0;
+    int current = 0; // lowest f that may be non-empty
+    size_t count = 0;
+
+public:
+    void reset(size_t /*cells*/, int maxStep)
+    {
+        size_t size = 1;
+        while (size < static_cast<size_t>(maxStep) + 1)
+        {
+            size <<= 1;
+        }
+        if (buckets.size() < size)
+        {
+            buckets.resize(size);
+        }
+        mask = static_cast<int>(buckets.size()) - 1;
+        if (count > 0)
+        {
+            for (auto &b : buckets)
+            {
+                b.clear();
+            }
+        }
+        count = 0;
+        current = 0;
+    }
+
+    bool empty() const
+    {
+        return count == 0;
+    }
+
+    void push(const NavNode &node)
+    {
+        if (count == 0 || node.f() < current)
+        {
+            current = node.f();
+        }
+        buckets[node.f() & mask].push_back(node);
+        count++;
+    }
+
+    void decrease(const NavNode &node, int /*oldF*/)
+    {
+        push(node);
+    }
+
+    NavNode pop()
+    {
+        while (buckets[current & mask].empty())
+        {
+            current++;
+        }
+        std::vector<NavNode> &b = buckets[current & mask];
+        NavNode node = b.back();
+        b.pop_back();
+        count--;
+        return node;
+    }
+
+    // may belong to a stale duplicate, as in the heap
+    int minF()
+    {
+        while (buckets[current & mask].empty())
+        {
+            current++;
+        }
+        return current;
+    }
+};
+
+// Compile-time choice of open list, see FG_PATH_OPEN_LIST_HEAP in CMakeLists.txt.
+#ifdef FG_PATH_OPEN_LIST_HEAP
+using PathOpenList = BinaryHeapOpenList;
+#else
+using PathOpenList = BucketOpenList;
+#endif
@@ -0,0 +1,209 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <queue>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <OgreFrameListener.h>
+#include "CostMap.h"
+#include "PathWorkerPool.h"
+#include "PathCache.h"
+
+// One asynchronous path search, shared between the submitter and the queue.
+class PathRequest
+{
+public:
+    enum Status
+    {
+        PENDING,
+        RUNNING,
+        DONE,
+        CANCELLED
+    };
+
+    CellKey start;
+    CellKey end;
+    int priority;
+    CellPath path; // valid once DONE, empty if no path exists
+    // Called on the render thread from PathRequestQueue::applyCompleted().
+    std::function<void(PathRequest *)> callback;
+
+private:
+    friend class PathRequestQueue;
+    std::atomic<int> status{PENDING};
+    uint64_t seq = 0;
+
+public:
+    PathRequest(CellKey start, CellKey end, int priority) : start(start), end(end), priority(priority)
+    {
+    }
+
+    int getStatus() const
+    {
+        return status.load();
+    }
+
+    bool isDone() const
+    {
+        return status.load() == DONE;
+    }
+
+    // The callback will not be called after this; a running search is dropped when it ends.
+    void cancel()
+    {
+        status.store(CANCELLED);
+    }
+};
+
+using PathRequestHandle = std::shared_ptr<PathRequest>;
+
+// Runs path requests on a PathWorkerPool, highest priority first (FIFO within
+// a priority), and hands finished ones back on the render thread, at most
+// maxAppliedPerFrame per frame so a mass order is spread over several frames.
+// The cost map must not change while requests are in flight.
+class PathRequestQueue : public Ogre::FrameListener
+{
+    struct Order
+    {
+        bool operator()(const PathRequestHandle &a, const PathRequestHandle &b) const
+        {
+            if (a->priority != b->priority)
+                return a->priority < b->priority;
+            return a->seq > b->seq;
+        }
+    };
+
+    const CostMap *costMap;
+    PathWorkerPool *pool;
+    PathCache *cache = nullptr;
+    int maxAppliedPerFrame;
+    int bidirectionalMinDistance = 32; // hex distance from which a route counts as long
+    uint64_t nextSeq = 0;
+
+    std::mutex mtx;
+    std::priority_queue<PathRequestHandle, std::vector<PathRequestHandle>, Order> pending;
+    std::deque<PathRequestHandle> completed;
+
+public:
+    PathRequestQueue(const CostMap *costMap, PathWorkerPool *pool, int maxAppliedPerFrame = 8)
+        : costMap(costMap), pool(pool), maxAppliedPerFrame(maxAppliedPerFrame)
+    {
+    }
+
+    void setMaxAppliedPerFrame(int max)
+    {
+        this->maxAppliedPerFrame = max;
+    }
+
+    // Routes at least this many cells long are searched from both ends; <= 0 never.
+    void setBidirectionalMinDistance(int distance)
+    {
+        this->bidirectionalMinDistance = distance;
+    }
+
+    // Serve searches through a cache built on the same cost map; null to search directly.
+    void setCache(PathCache *cache)
+    {
+        this->cache = cache;
+    }
+
+    PathRequestHandle submit(CellKey start, CellKey end, std::function<void(PathRequest *)> callback, int priority = 0)
+    {
+        PathRequestHandle req = std::make_shared<PathRequest>(start, end, priority);
+        req->callback = callback;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            req->seq = nextSeq++;
+            pending.push(req);
+        }
+        pool->post([this]()
+                   { this->runNext(); });
+        return req;
+    }
+
+    // Invoke callbacks of up to max finished requests; returns how many were applied.
+    int applyCompleted(int max)
+    {
+        int applied = 0;
+        while (applied < max)
+        {
+            PathRequestHandle req;
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                if (completed.empty())
+                {
+                    break;
+                }
+                req = completed.front();
+                completed.pop_front();
+            }
+            if (!req->isDone())
+            {
+                continue; // cancelled after it finished
+            }
+            if (req->callback)
+            {
+                req->callback(req.get());
+            }
+            applied++;
+        }
+        return applied;
+    }
+
+    bool frameStarted(const Ogre::FrameEvent &/*evt*/) override
+    {
+        applyCompleted(maxAppliedPerFrame);
+        return true;
+    }
+
+private:
+    // Worker side: one call per submit, takes the best pending request still wanted.
+    void runNext()
+    {
+        PathRequestHandle req;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            while (!pending.empty())
+            {
+                PathRequestHandle top = pending.top();
+                pending.pop();
+                int expected = PathRequest::PENDING;
+                if (top->status.compare_exchange_strong(expected, PathRequest::RUNNING))
+                {
+                    req = top;
+                    break;
+                }
+            }
+        }
+        if (!req)
+        {
+            return;
+        }
+
+        PathSearchMode mode = PathSearchMode::FORWARD;
+        if (bidirectionalMinDistance > 0 &&
+            CostMap::hexDistance(req->start.first, req->start.second, req->end.first, req->end.second) >= bidirectionalMinDistance)
+        {
+            mode = PathSearchMode::BIDIRECTIONAL;
+        }
+        if (cache)
+        {
+            cache->findPath(req->start.first, req->start.second, req->end.first, req->end.second,
+                            PathSearchContext::local(), req->path, mode);
+        }
+        else
+        {
+            costMap->findPath(req->start.first, req->start.second, req->end.first, req->end.second,
+                              PathSearchContext::local(), req->path, mode);
+        }
+
+        int expected = PathRequest::RUNNING;
+        if (req->status.compare_exchange_strong(expected, PathRequest::DONE))
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            completed.push_back(req);
+        }
+    }
+};
@@ -0,0 +1,123 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <memory>
+#include "PathOpenList.h"
+
+// Counters of the last search run with a context.
+struct PathSearchStats
+{
+    size_t expanded = 0;  // nodes closed
+    size_t pushes = 0;    // open list insertions
+    size_t decreases = 0; // open list key decreases
+    size_t pops = 0;      // open list removals, stale entries included
+
+    void add(const PathSearchStats &other)
+    {
+        expanded += other.expanded;
+        pushes += other.pushes;
+        decreases += other.decreases;
+        pops += other.pops;
+    }
+};
+
+// Reusable A* scratch space: dense per-cell arrays indexed like CostMap::costGrid.
+// An entry is only meaningful when its stamp equals the current generation,
+// so starting a new search is O(1) instead of clearing every array.
+// One context serves one search at a time; use local() for a per-thread instance.
+class PathSearchContext
+{
+public:
+    std::vector<int> gScore;
+    std::vector<int> parent;
+    std::vector<uint32_t> visited; // == generation: gScore/parent are valid
+    std::vector<uint32_t> closed;  // == generation: node is closed
+    PathOpenList open;
+    uint32_t generation = 0;
+    PathSearchStats stats;
+    std::vector<int> chain; // cell indices of the path found last, start first
+
+private:
+    std::unique_ptr<PathSearchContext> reverseCtx;
+
+public:
+    static PathSearchContext &local()
+    {
+        static thread_local PathSearchContext ctx;
+        return ctx;
+    }
+
+    // Second context for the goal side of a bidirectional search, created on first use.
+    PathSearchContext &reverse()
+    {
+        if (!reverseCtx)
+        {
+            reverseCtx.reset(new PathSearchContext());
+        }
+        return *reverseCtx;
+    }
+
+    void reset(size_t cells, int maxStep)
+    {
+        if (visited.size() != cells)
+        {
+            gScore.assign(cells, 0);
+            parent.assign(cells, -1);
+            visited.assign(cells, 0);
+            closed.assign(cells, 0);
+            generation = 0;
+        }
+        if (++generation == 0)
+        {
+            // stamps wrapped around, old entries could look current again
+            std::fill(visited.begin(), visited.end(), 0);
+            std::fill(closed.begin(), closed.end(), 0);
+            generation = 1;
+        }
+        open.reset(cells, maxStep);
+        stats = PathSearchStats();
+    }
+
+    bool isVisited(int idx) const
+    {
+        return visited[idx] == generation;
+    }
+
+    bool isClosed(int idx) const
+    {
+        return closed[idx] == generation;
+    }
+
+    void close(int idx)
+    {
+        closed[idx] = generation;
+        stats.expanded++;
+    }
+
+    void visit(int idx, int g, int from)
+    {
+        visited[idx] = generation;
+        gScore[idx] = g;
+        parent[idx] = from;
+    }
+
+    void push(const NavNode &node)
+    {
+        open.push(node);
+        stats.pushes++;
+    }
+
+    void decrease(const NavNode &node, int oldF)
+    {
+        open.decrease(node, oldF);
+        stats.decreases++;
+    }
+
+    NavNode pop()
+    {
+        stats.pops++;
+        return open.pop();
+    }
+};
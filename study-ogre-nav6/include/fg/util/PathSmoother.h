@@ -0,0 +1,80 @@
+#pragma once
+#include <vector>
+#include "CostMap.h"
+#include "CellPath.h"
+#include "HexCoord.h"
+
+// String pulling for cell paths: keeps only the cells where the path has to
+// turn. A run of cells is replaced by the straight line between its ends if
+// every cell under the line is walkable and the line costs no more than the
+// run. Lines along cell edges are checked on both sides, so a shortcut never
+// clips the corner of an obstacle. Waypoints come greedily: from each one the
+// line is stretched along the path as far as it stays valid.
+class PathSmoother
+{
+    const CostMap &costMap;
+
+public:
+    PathSmoother(const CostMap &costMap) : costMap(costMap)
+    {
+    }
+
+    // First cell, every turning cell, last cell.
+    std::vector<CellKey> smooth(const CellPath &path) const
+    {
+        std::vector<CellKey> cells(path.begin(), path.end());
+        std::vector<CellKey> waypoints;
+        if (cells.empty())
+        {
+            return waypoints;
+        }
+        // cost[i]: cost of walking the path from cells[0] to cells[i]
+        std::vector<int> cost(cells.size(), 0);
+        for (size_t i = 1; i < cells.size(); i++)
+        {
+            cost[i] = cost[i - 1] + costMap.getCost(cells[i].first, cells[i].second);
+        }
+
+        size_t anchor = 0;
+        waypoints.push_back(cells[0]);
+        while (anchor + 1 < cells.size())
+        {
+            size_t reach = anchor + 1;
+            while (reach + 1 < cells.size() && isShortcut(cells[anchor], cells[reach + 1], cost[reach + 1] - cost[anchor]))
+            {
+                reach++;
+            }
+            waypoints.push_back(cells[reach]);
+            anchor = reach;
+        }
+        return waypoints;
+    }
+
+    // True if the line from a to b is walkable and costs at most budget on either side.
+    bool isShortcut(CellKey a, CellKey b, int budget) const
+    {
+        return lineCost(a, b, +1) <= budget && lineCost(a, b, -1) <= budget;
+    }
+
+    // Cost of the cells under the line after a, INT_MAX if one is not walkable.
+    int lineCost(CellKey a, CellKey b, int side) const
+    {
+        int cost = 0;
+        bool first = true;
+        bool blocked = false;
+        Hex::line(a.first, a.second, b.first, b.second, [&](int x, int y)
+                  {
+            if (first)
+            {
+                first = false;
+                return;
+            }
+            int c = costMap.getCost(x, y);
+            if (c <= CostMap::OBSTACLE)
+            {
+                blocked = true;
+            }
+            cost += c; }, side);
+        return blocked ? INT_MAX : cost;
+    }
+};
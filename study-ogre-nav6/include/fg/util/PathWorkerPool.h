@@ -0,0 +1,157 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include "CostMap.h"
+
+struct PathQuery
+{
+    CellKey start;
+    CellKey end;
+};
+
+// Fixed set of worker threads for path finding.
+// Each worker searches with its own thread_local PathSearchContext, so
+// concurrent queries share nothing but the (read-only) CostMap.
+class PathWorkerPool
+{
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool stopping = false;
+
+public:
+    PathWorkerPool(int threads = 0)
+    {
+        if (threads <= 0)
+        {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (int i = 0; i < threads; i++)
+        {
+            workers.emplace_back([this]()
+                                 { this->run(); });
+        }
+    }
+
+    ~PathWorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (std::thread &t : workers)
+        {
+            t.join();
+        }
+    }
+
+    int getThreadCount() const
+    {
+        return static_cast<int>(workers.size());
+    }
+
+    // True on one of this pool's workers. Blocking there on other tasks of the
+    // pool can deadlock once every worker does it, so such callers run inline.
+    bool isWorkerThread() const
+    {
+        return current() == this;
+    }
+
+    // Run a task on one of the workers.
+    void post(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            tasks.push_back(std::move(task));
+        }
+        cv.notify_one();
+    }
+
+    // Finds a path for every query; results[i] receives the path of queries[i]
+    // (empty if there is none). results must already hold queries.size() entries,
+    // whose capacity is reused. Blocks until all are done; the caller helps out,
+    // and on a worker thread (e.g. in a PathRequestQueue callback) does it all.
+    // The cost map must not change while the batch runs.
+    void findPaths(const CostMap *costMap, const std::vector<PathQuery> &queries,
+                   std::vector<std::vector<Ogre::Vector2>> &results)
+    {
+        const size_t count = std::min(queries.size(), results.size());
+        const size_t chunk = 4;
+        std::atomic<size_t> next(0);
+        std::atomic<int> running(0);
+        std::mutex doneMtx;
+        std::condition_variable doneCv;
+
+        auto work = [&]()
+        {
+            PathSearchContext &ctx = PathSearchContext::local();
+            for (size_t begin = next.fetch_add(chunk); begin < count; begin = next.fetch_add(chunk))
+            {
+                size_t end = std::min(begin + chunk, count);
+                for (size_t i = begin; i < end; i++)
+                {
+                    const PathQuery &q = queries[i];
+                    costMap->findPath(q.start.first, q.start.second, q.end.first, q.end.second, ctx, results[i]);
+                }
+            }
+        };
+
+        int helpers = static_cast<int>(std::min<size_t>(workers.size(), (count + chunk - 1) / chunk));
+        if (isWorkerThread())
+        {
+            helpers = 0; // the others may all be waiting like this one
+        }
+        running = helpers;
+        for (int i = 0; i < helpers; i++)
+        {
+            post([&]()
+                 {
+                work();
+                std::lock_guard<std::mutex> lock(doneMtx);
+                if (--running == 0)
+                {
+                    doneCv.notify_all();
+                } });
+        }
+        work();
+
+        std::unique_lock<std::mutex> lock(doneMtx);
+        doneCv.wait(lock, [&running]()
+                    { return running == 0; });
+    }
+
+private:
+    static const PathWorkerPool *&current()
+    {
+        static thread_local const PathWorkerPool *pool = nullptr;
+        return pool;
+    }
+
+    void run()
+    {
+        current() = this;
+        for (;;)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cv.wait(lock, [this]()
+                        { return stopping || !tasks.empty(); });
+                if (stopping && tasks.empty())
+                {
+                    return;
+                }
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+        }
+    }
+};
@@ -0,0 +1,228 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <climits>
+#include <algorithm>
+
+// Space-time reservations for cooperative path finding: which agent holds a
+// cell at a tick. Ticks live in a ring of slots covering [now, now + horizon),
+// one small open-addressing hash (cell -> agent) per slot, so a lookup is a
+// probe or two and moving on to the next tick clears just the expired slot.
+class ReservationTable
+{
+    static constexpr uint64_t EMPTY = 0;
+
+    struct Slot
+    {
+        int tick = INT_MIN;
+        size_t used = 0;
+        std::vector<uint64_t> entries; // (cell + 1) << 32 | agent, EMPTY: free
+    };
+
+    std::vector<Slot> slots;
+    int mask;
+    int now = 0;
+
+public:
+    // horizon: furthest tick ahead of now that can be reserved, plus one.
+    ReservationTable(int horizon = 32, size_t agentsHint = 256)
+    {
+        int size = 1;
+        while (size < horizon + 1)
+        {
+            size <<= 1;
+        }
+        slots.resize(size);
+        mask = size - 1;
+        size_t capacity = 16;
+        while (capacity < agentsHint * 2)
+        {
+            capacity <<= 1;
+        }
+        for (Slot &slot : slots)
+        {
+            slot.entries.assign(capacity, EMPTY);
+        }
+    }
+
+    int getNow() const
+    {
+        return now;
+    }
+
+    int getHorizon() const
+    {
+        return mask;
+    }
+
+    // Moves time forward, dropping reservations before tick.
+    void advance(int tick)
+    {
+        for (; now < tick; now++)
+        {
+            clear(slots[now & mask]);
+        }
+    }
+
+    // Agent holding cell at tick, -1 if none (or the tick is out of range).
+    int holder(int cell, int tick) const
+    {
+        const Slot *slot = find(tick);
+        if (!slot)
+        {
+            return -1;
+        }
+        const size_t m = slot->entries.size() - 1;
+        for (size_t i = hash(cell) & m;; i = (i + 1) & m)
+        {
+            const uint64_t e = slot->entries[i];
+            if (e == EMPTY)
+            {
+                return -1;
+            }
+            if (cellOf(e) == cell)
+            {
+                return static_cast<int>(e & 0xFFFFFFFF);
+            }
+        }
+    }
+
+    bool isFree(int cell, int tick, int agent) const
+    {
+        int h = holder(cell, tick);
+        return h < 0 || h == agent;
+    }
+
+    // False if another agent holds the cell, or tick is outside [now, now + horizon).
+    bool reserve(int cell, int tick, int agent)
+    {
+        if (tick < now || tick >= now + mask)
+        {
+            return false;
+        }
+        Slot &slot = slots[tick & mask];
+        if (slot.tick != tick)
+        {
+            clear(slot);
+            slot.tick = tick;
+        }
+        if ((slot.used + 1) * 2 > slot.entries.size())
+        {
+            grow(slot);
+        }
+        const size_t m = slot.entries.size() - 1;
+        for (size_t i = hash(cell) & m;; i = (i + 1) & m)
+        {
+            uint64_t &e = slot.entries[i];
+            if (e == EMPTY)
+            {
+                e = entry(cell, agent);
+                slot.used++;
+                return true;
+            }
+            if (cellOf(e) == cell)
+            {
+                return static_cast<int>(e & 0xFFFFFFFF) == agent;
+            }
+        }
+    }
+
+    // Drops the reservation if agent holds it.
+    void release(int cell, int tick, int agent)
+    {
+        Slot *slot = find(tick);
+        if (!slot)
+        {
+            return;
+        }
+        std::vector<uint64_t> &entries = slot->entries;
+        const size_t m = entries.size() - 1;
+        size_t i = hash(cell) & m;
+        for (;; i = (i + 1) & m)
+        {
+            if (entries[i] == EMPTY)
+            {
+                return;
+            }
+            if (cellOf(entries[i]) == cell)
+            {
+                break;
+            }
+        }
+        if (static_cast<int>(entries[i] & 0xFFFFFFFF) != agent)
+        {
+            return;
+        }
+        // backward-shift deletion keeps every probe chain unbroken without tombstones
+        size_t hole = i;
+        for (size_t j = (i + 1) & m; entries[j] != EMPTY; j = (j + 1) & m)
+        {
+            const size_t home = hash(cellOf(entries[j])) & m;
+            if (((j - home) & m) >= ((j - hole) & m))
+            {
+                entries[hole] = entries[j];
+                hole = j;
+            }
+        }
+        entries[hole] = EMPTY;
+        slot->used--;
+    }
+
+private:
+    static uint64_t entry(int cell, int agent)
+    {
+        return (static_cast<uint64_t>(cell + 1) << 32) | static_cast<uint32_t>(agent);
+    }
+
+    static int cellOf(uint64_t e)
+    {
+        return static_cast<int>(e >> 32) - 1;
+    }
+
+    static size_t hash(int cell)
+    {
+        uint32_t h = static_cast<uint32_t>(cell) * 2654435761u;
+        return h ^ (h >> 16);
+    }
+
+    const Slot *find(int tick) const
+    {
+        const Slot &slot = slots[tick & mask];
+        return slot.tick == tick && tick >= now ? &slot : nullptr;
+    }
+
+    Slot *find(int tick)
+    {
+        Slot &slot = slots[tick & mask];
+        return slot.tick == tick && tick >= now ? &slot : nullptr;
+    }
+
+    static void clear(Slot &slot)
+    {
+        if (slot.used > 0)
+        {
+            std::fill(slot.entries.begin(), slot.entries.end(), EMPTY);
+            slot.used = 0;
+        }
+        slot.tick = INT_MIN;
+    }
+
+    static void grow(Slot &slot)
+    {
+        std::vector<uint64_t> old(slot.entries.size() * 2, EMPTY);
+        old.swap(slot.entries);
+        const size_t m = slot.entries.size() - 1;
+        for (uint64_t e : old)
+        {
+            if (e != EMPTY)
+            {
+                size_t i = hash(cellOf(e)) & m;
+                while (slot.entries[i] != EMPTY)
+                {
+                    i = (i + 1) & m;
+                }
+                slot.entries[i] = e;
+            }
+        }
+    }
+};
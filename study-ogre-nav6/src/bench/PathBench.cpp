@@ -0,0 +1,378 @@
+// PathBench - headless benchmark of CostMap path searches, no window or render system.
+//
+//   PathBench [--maps random,maze,open,weighted] [--sizes 64,256,1024,4096]
+//             [--queries N] [--seed N] [--mode forward|bidirectional]
+//   PathBench --map file.map|file.hxcm [--scen file.scen] [--queries N] ...
+//
+// For each map it prints per-query latency percentiles and, averaged per query,
+// nodes expanded, open list operations (pushes, decreases, pops) and heap
+// allocations. Generated maps get random start/goal pairs that are connected;
+// a MovingAI scenario supplies its own. The open list follows the build, see
+// FG_PATH_OPEN_LIST_HEAP.
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <memory>
+#include <new>
+#include <algorithm>
+#include "fg/util/CostMap.h"
+#include "fg/util/CostMapFile.h"
+#include "fg/util/CostMapComponents.h"
+#include "fg/util/MovingAiFile.h"
+
+// === Allocation counting ===
+static std::atomic<size_t> allocations{0};
+
+void *operator new(std::size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+struct BenchQuery
+{
+    int startX, startY, endX, endY;
+};
+
+struct BenchOptions
+{
+    std::vector<std::string> maps = {"random", "maze", "open", "weighted"};
+    std::vector<int> sizes = {64, 256, 1024, 4096};
+    int queries = 0; // 0: by map size
+    unsigned seed = 1;
+    PathSearchMode mode = PathSearchMode::FORWARD;
+    std::string mapFile;
+    std::string scenFile;
+};
+
+// === Generated maps ===
+static CostMap *makeOpen(int size, std::mt19937 &/*rng*/)
+{
+    return new CostMap(size, size);
+}
+
+// Every cell an obstacle with a chance of one in four.
+static CostMap *makeRandom(int size, std::mt19937 &rng)
+{
+    CostMap *map = new CostMap(size, size);
+    for (int y = 0; y < size; y++)
+    {
+        for (int x = 0; x < size; x++)
+        {
+            if (rng() % 4 == 0)
+                map->setCost(x, y, CostMap::OBSTACLE);
+        }
+    }
+    return map;
+}
+
+// Perfect maze with one-cell corridors: rooms on even (x, y), carved by a
+// depth-first walk. (x, y + 1) touches both (x, y) and (x, y + 2) on the hex
+// layout when y is even, so vertical corridors work as horizontal ones.
+static CostMap *makeMaze(int size, std::mt19937 &rng)
+{
+    CostMap *map = new CostMap(size, size);
+    for (int y = 0; y < size; y++)
+    {
+        for (int x = 0; x < size; x++)
+        {
+            map->setCost(x, y, CostMap::OBSTACLE);
+        }
+    }
+    const int rooms = (size + 1) / 2;
+    std::vector<uint8_t> seen(static_cast<size_t>(rooms) * rooms, 0);
+    std::vector<int> stack = {0};
+    seen[0] = 1;
+    map->setCost(0, 0, CostMap::DEFAULT_COST);
+    static constexpr int DX[4] = {1, -1, 0, 0};
+    static constexpr int DY[4] = {0, 0, 1, -1};
+    while (!stack.empty())
+    {
+        const int room = stack.back();
+        const int rx = room % rooms, ry = room / rooms;
+        int next[4], count = 0;
+        for (int d = 0; d < 4; d++)
+        {
+            const int nx = rx + DX[d], ny = ry + DY[d];
+            if (nx >= 0 && nx < rooms && ny >= 0 && ny < rooms && !seen[ny * rooms + nx])
+                next[count++] = d;
+        }
+        if (count == 0)
+        {
+            stack.pop_back();
+            continue;
+        }
+        const int d = next[rng() % count];
+        const int nx = rx + DX[d], ny = ry + DY[d];
+        seen[ny * rooms + nx] = 1;
+        map->setCost(2 * rx + DX[d], 2 * ry + DY[d], CostMap::DEFAULT_COST);
+        map->setCost(2 * nx, 2 * ny, CostMap::DEFAULT_COST);
+        stack.push_back(ny * rooms + nx);
+    }
+    return map;
+}
+
+// Costs 1..9 from value noise on a 32-cell lattice, so cheap valleys and
+// expensive hills span many cells.
+static CostMap *makeWeighted(int size, std::mt19937 &rng)
+{
+    CostMap *map = new CostMap(size, size);
+    const int cell = 32;
+    const int lattice = size / cell + 2;
+    std::vector<float> noise(static_cast<size_t>(lattice) * lattice);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (float &v : noise)
+    {
+        v = unit(rng);
+    }
+    for (int y = 0; y < size; y++)
+    {
+        const int ly = y / cell;
+        const float fy = static_cast<float>(y % cell) / cell;
+        for (int x = 0; x < size; x++)
+        {
+            const int lx = x / cell;
+            const float fx = static_cast<float>(x % cell) / cell;
+            const float top = noise[ly * lattice + lx] * (1 - fx) + noise[ly * lattice + lx + 1] * fx;
+            const float bottom = noise[(ly + 1) * lattice + lx] * (1 - fx) + noise[(ly + 1) * lattice + lx + 1] * fx;
+            const float v = top * (1 - fy) + bottom * fy;
+            map->setCost(x, y, 1 + std::min(8, static_cast<int>(v * 9)));
+        }
+    }
+    return map;
+}
+
+static CostMap *makeMap(const std::string &name, int size, std::mt19937 &rng)
+{
+    if (name == "open")
+        return makeOpen(size, rng);
+    if (name == "random")
+        return makeRandom(size, rng);
+    if (name == "maze")
+        return makeMaze(size, rng);
+    if (name == "weighted")
+        return makeWeighted(size, rng);
+    return nullptr;
+}
+
+// Random start/goal pairs on walkable cells of one component.
+static std::vector<BenchQuery> makeQueries(CostMap &map, int count, std::mt19937 &rng)
+{
+    std::vector<BenchQuery> queries;
+    CostMapComponents components(&map);
+    const int w = map.getWidth(), h = map.getHeight();
+    if (map.countWalkable(0, 0, w - 1, h - 1) < 2)
+    {
+        return queries;
+    }
+    auto randomCell = [&]()
+    {
+        CellKey c;
+        do
+        {
+            c = {static_cast<int>(rng() % w), static_cast<int>(rng() % h)};
+        } while (!map.isWalkable(c.first, c.second));
+        return c;
+    };
+    for (int tries = 0; static_cast<int>(queries.size()) < count && tries < count * 100; tries++)
+    {
+        const CellKey start = randomCell();
+        const CellKey end = randomCell();
+        if (start != end && components.isReachable(start, end))
+        {
+            queries.push_back({start.first, start.second, end.first, end.second});
+        }
+    }
+    return queries;
+}
+
+static void printHeader()
+{
+    std::printf("%-24s %9s %7s %7s %9s %9s %9s %9s %10s %10s %8s\n", "map", "size", "queries", "found", "p50 us",
+                "p90 us", "p99 us", "max us", "expanded", "open ops", "allocs");
+}
+
+static void run(const std::string &name, CostMap &map, const std::vector<BenchQuery> &queries,
+                const BenchOptions &options)
+{
+    if (queries.empty())
+    {
+        std::printf("%-24s no queries\n", name.c_str());
+        return;
+    }
+    PathSearchContext ctx;
+    CellPath path;
+    // sizes the context once, as a long-lived one would be
+    map.findPath(queries[0].startX, queries[0].startY, queries[0].endX, queries[0].endY, ctx, path, options.mode);
+
+    std::vector<double> latency;
+    latency.reserve(queries.size());
+    size_t found = 0, expanded = 0, openOps = 0, allocs = 0;
+    for (const BenchQuery &q : queries)
+    {
+        const size_t allocsBefore = allocations.load(std::memory_order_relaxed);
+        const auto t0 = std::chrono::steady_clock::now();
+        const bool ok = map.findPath(q.startX, q.startY, q.endX, q.endY, ctx, path, options.mode);
+        const auto t1 = std::chrono::steady_clock::now();
+        allocs += allocations.load(std::memory_order_relaxed) - allocsBefore;
+        latency.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+        found += ok;
+        expanded += ctx.stats.expanded;
+        openOps += ctx.stats.pushes + ctx.stats.decreases + ctx.stats.pops;
+    }
+    std::sort(latency.begin(), latency.end());
+    auto percentile = [&latency](double p)
+    {
+        return latency[std::min(latency.size() - 1, static_cast<size_t>(p * latency.size()))];
+    };
+    const double n = static_cast<double>(queries.size());
+    const std::string size = std::to_string(map.getWidth()) + "x" + std::to_string(map.getHeight());
+    std::printf("%-24s %9s %7zu %7zu %9.1f %9.1f %9.1f %9.1f %10.0f %10.0f %8.2f\n", name.c_str(), size.c_str(),
+                queries.size(), found, percentile(0.5), percentile(0.9), percentile(0.99), latency.back(),
+                expanded / n, openOps / n, allocs / n);
+    std::fflush(stdout);
+}
+
+static std::vector<std::string> split(const std::string &list)
+{
+    std::vector<std::string> items;
+    size_t from = 0;
+    while (from <= list.size())
+    {
+        size_t to = list.find(',', from);
+        if (to == std::string::npos)
+            to = list.size();
+        if (to > from)
+            items.push_back(list.substr(from, to - from));
+        from = to + 1;
+    }
+    return items;
+}
+
+static bool parseOptions(int argc, char **argv, BenchOptions &options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc)
+        {
+            return false;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--maps")
+        {
+            options.maps = split(value);
+        }
+        else if (arg == "--sizes")
+        {
+            options.sizes.clear();
+            for (const std::string &s : split(value))
+                options.sizes.push_back(std::atoi(s.c_str()));
+        }
+        else if (arg == "--queries")
+            options.queries = std::atoi(value.c_str());
+        else if (arg == "--seed")
+            options.seed = static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 10));
+        else if (arg == "--mode" && (value == "forward" || value == "bidirectional"))
+            options.mode = value == "forward" ? PathSearchMode::FORWARD : PathSearchMode::BIDIRECTIONAL;
+        else if (arg == "--map")
+            options.mapFile = value;
+        else if (arg == "--scen")
+            options.scenFile = value;
+        else
+            return false;
+    }
+    return true;
+}
+
+static CostMap *loadMap(const std::string &file)
+{
+    if (file.size() > 5 && file.compare(file.size() - 5, 5, ".hxcm") == 0)
+    {
+        MappedCostLayer layer;
+        return CostMapFile::open(file, layer) ? new CostMap(layer) : nullptr;
+    }
+    return MovingAiFile::loadMap(file);
+}
+
+int main(int argc, char **argv)
+{
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options))
+    {
+        std::cerr << "usage: PathBench [--maps random,maze,open,weighted] [--sizes 64,256,1024,4096]\n"
+                     "                 [--queries N] [--seed N] [--mode forward|bidirectional]\n"
+                     "                 [--map file.map|file.hxcm [--scen file.scen]]\n";
+        return 2;
+    }
+    std::mt19937 rng(options.seed);
+    printHeader();
+
+    if (!options.mapFile.empty())
+    {
+        std::unique_ptr<CostMap> map(loadMap(options.mapFile));
+        if (!map)
+        {
+            std::cerr << "cannot load " << options.mapFile << "\n";
+            return 1;
+        }
+        std::vector<BenchQuery> queries;
+        if (!options.scenFile.empty())
+        {
+            std::vector<MovingAiQuery> scenario;
+            if (!MovingAiFile::loadScenario(options.scenFile, scenario))
+            {
+                std::cerr << "cannot load " << options.scenFile << "\n";
+                return 1;
+            }
+            for (const MovingAiQuery &q : scenario)
+            {
+                queries.push_back({q.startX, q.startY, q.goalX, q.goalY});
+            }
+            if (options.queries > 0 && static_cast<int>(queries.size()) > options.queries)
+                queries.resize(options.queries);
+        }
+        else
+        {
+            queries = makeQueries(*map, options.queries > 0 ? options.queries : 200, rng);
+        }
+        run(options.mapFile, *map, queries, options);
+        return 0;
+    }
+
+    for (int size : options.sizes)
+    {
+        for (const std::string &name : options.maps)
+        {
+            std::unique_ptr<CostMap> map(makeMap(name, size, rng));
+            if (!map)
+            {
+                std::cerr << "unknown map type " << name << "\n";
+                return 2;
+            }
+            // long searches on big maps: fewer of them
+            const int count = options.queries > 0 ? options.queries : std::max(20, 200 * 256 / size);
+            run(name, *map, makeQueries(*map, count, rng), options);
+        }
+    }
+    return 0;
+}
@@ -4,13 +4,15 @@
 void HexGridPrinter::printCostGrid(CostMap &grid)
 {
     std::cout << "Original Cost Grid (0=obstacle, 1=normal, 2=costly, 3=very costly):\n";
+    const CostLayer costs = grid.getCostGrid();
     for (int y = 0; y < grid.height; y++)
     {
-        if (y % 2 == 1)
+        const uint8_t *row = &costs[grid.index(0, y)];
+        if (Hex::isShifted(y))
             std::cout << " ";
         for (int x = 0; x < grid.width; x++)
         {
-            int cost = grid.costGrid[y][x];
+            int cost = row[x];
             if (cost == grid.OBSTACLE)
             {
                 std::cout << "# ";
@@ -37,14 +39,16 @@ void HexGridPrinter::printPathGrid(CostMap *grid, int startx , int starty , int
         pathSet.insert({static_cast<int>(p.x), static_cast<int>(p.y)});
     }
 
+    const CostLayer costs = grid->getCostGrid();
     for (int y = 0; y < grid->height; y++)
     {
-        if (y % 2 == 1)
+        const uint8_t *row = &costs[grid->index(0, y)];
+        if (Hex::isShifted(y))
             std::cout << " ";
         for (int x = 0; x < grid->width; x++)
         {
             char c = '.';
-            int cost = grid->costGrid[y][x];
+            int cost = row[x];
 
             if (x == startx && y == starty)
             {
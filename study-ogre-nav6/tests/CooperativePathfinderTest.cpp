@@ -0,0 +1,46 @@
+// CooperativePathfinderTest - an agent that cannot plan must keep its cell
+// reserved, so agents planned after it do not walk into it.
+// One-row corridor: B crosses it first and boxes A in on its goal; C follows
+// B and must stop short of A for the whole window. Exits non-zero otherwise.
+#include <cstdio>
+#include "fg/util/CostMap.h"
+#include "fg/util/CooperativePathfinder.h"
+
+int main()
+{
+    const int w = 10, h = 3, window = 16;
+    CostMap map(w, h);
+    for (int x = 0; x < w; x++)
+    {
+        map.setCost(x, 0, CostMap::OBSTACLE);
+        map.setCost(x, 2, CostMap::OBSTACLE);
+    }
+    CooperativePathfinder planner(&map, nullptr, window, 8);
+    const int b = planner.addAgent({1, 1}, {9, 1});
+    const int a = planner.addAgent({5, 1}, {5, 1}); // B passes through: no plan fits
+    const int c = planner.addAgent({0, 1}, {7, 1});
+    if (a < 0 || b < 0 || c < 0)
+    {
+        std::printf("FAIL agents not added\n");
+        return 1;
+    }
+    bool ok = true;
+    for (int dt = 1; dt <= window; dt++)
+    {
+        const CellKey cellA = planner.getPlannedCell(a, dt);
+        const CellKey cellC = planner.getPlannedCell(c, dt);
+        if (cellA != CellKey(5, 1))
+        {
+            std::printf("FAIL boxed-in agent leaves its cell at tick %d\n", dt);
+            ok = false;
+        }
+        if (cellC == cellA)
+        {
+            std::printf("FAIL tick %d: later agent planned into the boxed-in agent's cell (%d,%d)\n", dt,
+                        cellC.first, cellC.second);
+            ok = false;
+        }
+    }
+    std::printf("%s\n", ok ? "boxed-in cell held" : "boxed-in cell not held");
+    return ok ? 0 : 1;
+}
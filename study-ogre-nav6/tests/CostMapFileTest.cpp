@@ -0,0 +1,86 @@
+// CostMapFileTest - open() must refuse files whose cells and mask disagree.
+// Saves a map, tampers with one byte at a time, and exits non-zero if a
+// tampered file is still accepted or the untouched one is not.
+#include <cstdio>
+#include <string>
+#include "fg/util/CostMap.h"
+#include "fg/util/CostMapFile.h"
+
+static const char *PATH = "CostMapFileTest.hxcm";
+static const char *TAMPERED = "CostMapFileTest.tampered.hxcm";
+
+static bool opens(const char *path)
+{
+    MappedCostLayer layer;
+    return CostMapFile::open(path, layer);
+}
+
+// Copy of PATH with the byte at offset xored with bits.
+static bool tamper(uint64_t offset, uint8_t bits)
+{
+    std::FILE *in = std::fopen(PATH, "rb");
+    std::FILE *out = std::fopen(TAMPERED, "wb");
+    if (!in || !out)
+        return false;
+    int c;
+    for (uint64_t i = 0; (c = std::fgetc(in)) != EOF; i++)
+    {
+        std::fputc(i == offset ? c ^ bits : c, out);
+    }
+    std::fclose(in);
+    std::fclose(out);
+    return true;
+}
+
+int main()
+{
+    const int w = 70, h = 9; // two mask words per row, the second partly past the width
+    CostMap map(w, h);
+    for (int y = 0; y < h; y++)
+    {
+        for (int x = 0; x < w; x++)
+        {
+            map.setCost(x, y, (x + y) % 7 == 0 ? CostMap::OBSTACLE : 1 + (x * y) % 3);
+        }
+    }
+    if (!CostMapFile::save(map, PATH, 0, false) || !opens(PATH))
+    {
+        std::printf("FAIL saved map does not open\n");
+        return 1;
+    }
+    CostMapFileHeader header;
+    std::FILE *f = std::fopen(PATH, "rb");
+    const bool read = f && std::fread(&header, sizeof(header), 1, f) == 1;
+    if (f)
+        std::fclose(f);
+    if (!read)
+        return 1;
+
+    struct Case
+    {
+        const char *what;
+        uint64_t offset;
+        uint8_t bits;
+    };
+    const uint64_t row2 = header.maskOffset + 2 * 2 * sizeof(uint64_t);
+    const Case cases[] = {
+        {"walkable cell cleared in mask", row2, 0x02},        // (1, 2) costs 1 + 2 % 3
+        {"obstacle cell set in mask", row2, 0x20},            // (5, 2): (5 + 2) % 7 == 0
+        {"bit past the width", row2 + sizeof(uint64_t), 0x40}, // x = 70
+        {"last row, bit past the width", header.maskOffset + header.maskBytes - 1, 0x80},
+        {"cell above maxCost", header.costOffset + (3 + 1) * (w + 2) + 4, 0x40},
+    };
+    bool ok = true;
+    for (const Case &c : cases)
+    {
+        if (!tamper(c.offset, c.bits) || opens(TAMPERED))
+        {
+            std::printf("FAIL accepted: %s\n", c.what);
+            ok = false;
+        }
+    }
+    std::remove(PATH);
+    std::remove(TAMPERED);
+    std::printf("%s\n", ok ? "tampered files rejected" : "tampered files accepted");
+    return ok ? 0 : 1;
+}
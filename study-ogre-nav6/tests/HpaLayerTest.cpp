@@ -0,0 +1,53 @@
+// HpaLayerTest - HPA* must find a path whenever a full search over the grid does.
+// Random static maps, several cluster sizes; exits non-zero on the first miss.
+#include <cstdio>
+#include <random>
+#include "fg/util/CostMap.h"
+#include "fg/util/HpaLayer.h"
+
+static bool checkMaps(int clusterSize, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    PathSearchContext ctx;
+    int queries = 0;
+    for (int map = 0; map < 100; map++)
+    {
+        const int w = 20 + rng() % 60, h = 20 + rng() % 60;
+        const int obstacles = rng() % 45; // percent
+        CostMap costMap(w, h);
+        for (int y = 0; y < h; y++)
+        {
+            for (int x = 0; x < w; x++)
+            {
+                costMap.setCost(x, y, static_cast<int>(rng() % 100) < obstacles ? CostMap::OBSTACLE : 1 + rng() % 3);
+            }
+        }
+        HpaLayer hpa(&costMap, clusterSize);
+        for (int q = 0; q < 30; q++)
+        {
+            const int sx = rng() % w, sy = rng() % h, ex = rng() % w, ey = rng() % h;
+            CellPath full;
+            if (!costMap.findPath(sx, sy, ex, ey, ctx, full))
+                continue;
+            queries++;
+            if (hpa.findPath(sx, sy, ex, ey).empty())
+            {
+                std::printf("FAIL cluster %d map %dx%d: (%d,%d) -> (%d,%d) has a path, HPA* found none\n", clusterSize,
+                            w, h, sx, sy, ex, ey);
+                return false;
+            }
+        }
+    }
+    std::printf("cluster %d: %d reachable queries ok\n", clusterSize, queries);
+    return true;
+}
+
+int main()
+{
+    bool ok = true;
+    for (int clusterSize : {3, 4, 8, 16})
+    {
+        ok = checkMaps(clusterSize, 1234u + clusterSize) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -1,53 +1,55 @@
 #include <Ogre.h>
 #include <vector>
-#include <queue>
-#include <unordered_map>
+#include <cstdint>
+#include <algorithm>
 #include <cmath>
 #include <iostream>
-
-// 2D导航网格节点
-struct NavNode {
-    int x, y;
-    float g, h;  // g:实际代价, h:启发函数
-    float f() const { return g + h; }
-    bool operator>(const NavNode& other) const { return f() > other.f(); }
-    bool operator==(const NavNode& other) const { return x == other.x && y == other.y; }
-    
-    // 用于unordered_map的哈希函数
-    struct Hash {
-        size_t operator()(const NavNode& node) const {
-            return std::hash<int>()(node.x) ^ std::hash<int>()(node.y);
-        }
-    };
-};
+#include "fg/util/GridSearch.h"
 
 // 2D导航网格类
+// 寻路使用 fg/util/GridSearch.h 的 A* 模板 (八方向拓扑), 与 study-ogre-nav6 的六边形网格共用
 class NavigationGrid2D {
 private:
-    std::vector<std::vector<bool>> grid;  // true=可通行, false=障碍物
-    int width, height;
+    std::vector<uint8_t> cells;  // 1=可通行, 0=障碍物; 外围一圈障碍物, 下标见index()
+    int width, height, stride;
     
 public:
-    NavigationGrid2D(int w, int h) : width(w), height(h) {
-        grid.resize(height, std::vector<bool>(width, true));  // 默认全部可通行
+    // 整数代价 (放大1000倍), 对角线为1.414
+    static constexpr int STRAIGHT_COST = 1000;
+    static constexpr int DIAGONAL_COST = 1414;
+    // 与 SquareTopology8 的方向顺序一致
+    static constexpr int STEP_COST[8] = {DIAGONAL_COST, STRAIGHT_COST, DIAGONAL_COST, STRAIGHT_COST,
+                                         STRAIGHT_COST, DIAGONAL_COST, STRAIGHT_COST, DIAGONAL_COST};
+    
+    NavigationGrid2D(int w, int h) : width(w), height(h), stride(w + 2) {
+        cells.assign(static_cast<size_t>(stride) * (height + 2), 0);
+        for (int y = 0; y < height; y++) {
+            std::fill_n(cells.begin() + index(0, y), width, 1);  // 默认全部可通行
+        }
+    }
+    
+    int index(int x, int y) const {
+        return (y + 1) * stride + (x + 1);
     }
     
     // 设置障碍物
     void setObstacle(int x, int y, bool isObstacle = true) {
         if (x >= 0 && x < width && y >= 0 && y < height) {
-            grid[y][x] = !isObstacle;
+            cells[index(x, y)] = !isObstacle;
         }
     }
     
     // 检查位置是否可通行
     bool isWalkable(int x, int y) const {
         if (x < 0 || x >= width || y < 0 || y >= height) return false;
-        return grid[y][x];
+        return cells[index(x, y)];
     }
     
-    // 计算启发函数（曼哈顿距离）
-    float heuristic(int x1, int y1, int x2, int y2) const {
-        return std::abs(x1 - x2) + std::abs(y1 - y2);
+    // 启发函数（八方向距离）: 不会高估, 找到的路径是最短的
+    int heuristic(int x1, int y1, int x2, int y2) const {
+        int dx = std::abs(x1 - x2);
+        int dy = std::abs(y1 - y2);
+        return STRAIGHT_COST * std::max(dx, dy) + (DIAGONAL_COST - STRAIGHT_COST) * std::min(dx, dy);
     }
     
     // A*算法寻找最短路径
@@ -56,70 +58,23 @@ public:
             return {};  // 起点或终点不可通行
         }
         
-        std::priority_queue<NavNode, std::vector<NavNode>, std::greater<NavNode>> openList;
-        std::unordered_map<NavNode, NavNode, NavNode::Hash> cameFrom;
-        std::unordered_map<NavNode, float, NavNode::Hash> gScore;
-        
-        NavNode start = {startX, startY, 0, heuristic(startX, startY, endX, endY)};
-        openList.push(start);
-        gScore[start] = 0;
-        
-        // 8方向移动（包括对角线）
-        int dx[8] = {-1, -1, -1,  0, 0,  1, 1, 1};
-        int dy[8] = {-1,  0,  1, -1, 1, -1, 0, 1};
-        float costs[8] = {1.414f, 1.0f, 1.414f, 1.0f, 1.0f, 1.414f, 1.0f, 1.414f};  // 对角线成本
-        
-        while (!openList.empty()) {
-            NavNode current = openList.top();
-            openList.pop();
-            
-            if (current.x == endX && current.y == endY) {
-                // 重建路径
-                return reconstructPath(cameFrom, current);
-            }
-            
-            // 检查8个相邻节点
-            for (int i = 0; i < 8; i++) {
-                int nx = current.x + dx[i];
-                int ny = current.y + dy[i];
-                
-                if (!isWalkable(nx, ny)) continue;
-                
-                float tentativeG = gScore[current] + costs[i];
-                
-                if (gScore.find({nx, ny}) == gScore.end() || tentativeG < gScore[{nx, ny}]) {
-                    cameFrom[{nx, ny}] = current;
-                    gScore[{nx, ny}] = tentativeG;
-                    float h = heuristic(nx, ny, endX, endY);
-                    
-                    NavNode neighbor = {nx, ny, tentativeG, h};
-                    openList.push(neighbor);
-                }
-            }
+        PathSearchContext &ctx = PathSearchContext::local();
+        const uint8_t *grid = cells.data();
+        auto cost = [grid](int, int to, int direction) { return grid[to] ? STEP_COST[direction] : 0; };
+        auto h = [this, endX, endY](int x, int y, int) { return heuristic(x, y, endX, endY); };
+        // 每一步 f 最多增加两倍步长代价
+        if (!GridSearch::findPath<SquareTopology8>(stride, cells.size(), startX, startY, endX, endY, cost, h,
+                                                   2 * DIAGONAL_COST, ctx)) {
+            return {}; // 无路径
         }
         
-        return {}; // 无路径
-    }
-    
-private:
-    std::vector<Ogre::Vector2> reconstructPath(
-        const std::unordered_map<NavNode, NavNode, NavNode::Hash>& cameFrom,
-        const NavNode& current) const {
-        
         std::vector<Ogre::Vector2> path;
-        NavNode node = current;
-        
-        while (cameFrom.find(node) != cameFrom.end()) {
-            path.push_back(Ogre::Vector2(node.x, node.y));
-            node = cameFrom.at(node);
+        for (int idx : ctx.chain) {
+            path.push_back(Ogre::Vector2(idx % stride - 1, idx / stride - 1));
         }
-        path.push_back(Ogre::Vector2(node.x, node.y));  // 添加起点
-        
-        std::reverse(path.begin(), path.end());
         return path;
     }
     
-public:
     // 可视化网格（用于调试）
     void printGrid(int startx = -1, int starty = -1, int endx = -1, int endy = -1) const {
         for (int y = 0; y < height; y++) {
@@ -128,7 +83,7 @@ public:
                     std::cout << "S ";  // 起点
                 } else if (x == endx && y == endy) {
                     std::cout << "E ";  // 终点
-                } else if (!grid[y][x]) {
+                } else if (!isWalkable(x, y)) {
                     std::cout << "# ";  // 障碍物
                 } else {
                     std::cout << ". ";  // 可通行